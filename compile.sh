@@ -5,4 +5,8 @@
 ########################################
 
 # Compile C++ code with g++
-g++ -std=c++17 -Wall -Ofast -flto -march=native -funroll-loops -fomit-frame-pointer -I src/ src/main.cpp src/dimacs_parser.cpp src/solvers/dpll.cpp -o dpll_solver
\ No newline at end of file
+g++ -std=c++17 -Wall -Ofast -flto -march=native -funroll-loops -fomit-frame-pointer -I src/ src/main.cpp src/dimacs_parser.cpp src/output.cpp src/server.cpp src/instance_features.cpp src/solvers/dpll.cpp src/solvers/gauss.cpp src/solvers/clause_eval.cpp src/solvers/components.cpp src/solvers/drat.cpp -pthread -o dpll_solver
+
+# Benchmark tools: instance generator and scaling sweep driver
+g++ -std=c++17 -Wall -O2 -I src/ src/tools/gen_cnf.cpp src/generators.cpp src/output.cpp -o gen_cnf
+g++ -std=c++17 -Wall -Ofast -flto -march=native -funroll-loops -fomit-frame-pointer -I src/ src/tools/bench_scaling.cpp src/generators.cpp src/instance_features.cpp src/solvers/dpll.cpp src/solvers/gauss.cpp src/solvers/clause_eval.cpp src/solvers/drat.cpp -pthread -o bench_scaling
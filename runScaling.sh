@@ -0,0 +1,43 @@
+#!/bin/bash
+
+########################################
+############# CSCI 2951-O ##############
+########################################
+E_BADARGS=65
+if [ $# -ne 2 ]
+then
+	echo "Usage: `basename $0` <timeLimit> <logFile>"
+	echo "Description:"
+	echo -e "\t This script sweeps ./bench_scaling over the generated instance families"
+	echo -e "\t (random 3-SAT at ratio 4.26, pigeonhole, parity, 3-coloring)."
+	echo -e "\t Each solver run is subject to the given time limit in seconds; a family stops"
+	echo -e "\t growing once most runs of a size time out."
+	echo -e "\t One JSON line per family and size, then a growth fit per family, is appended to the logFile."
+	echo -e "\t If the logFile already exists, the run is aborted."
+	exit $E_BADARGS
+fi
+
+# Parameters
+timeLimit=$1
+logFile=$2
+
+# Terminate if the log file already exists
+[ -f $logFile ] && echo "Logfile $logFile already exists, terminating." && exit 1
+
+# Create the log file
+touch $logFile
+
+# Family, first size, last size, step, extra generator options
+sweeps=(
+	"ksat 50 250 25 --ratio 4.26"
+	"pigeonhole 4 12 1"
+	"parity 10 80 10"
+	"coloring 20 200 20 --colors 3 --degree 4.0"
+)
+
+for sweep in "${sweeps[@]}"
+do
+	echo "Running $sweep"
+	set -- $sweep
+	./bench_scaling $1 $2 $3 --step $4 "${@:5}" --seeds 5 --timeout $timeLimit >> $logFile
+done
@@ -1,10 +1,79 @@
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "dimacs_parser.h"
+
 std::vector<std::vector<int>> parse_cnf_file(const std::string& filename) {
-    std::vector<std::vector<int>> clauses;
+    Formula formula = parse_dimacs_file(filename);
+
+    if (!formula.xor_clauses.empty() || !formula.at_most.empty()) {
+        throw std::runtime_error("Error: DIMACS file contains XOR or cardinality constraints");
+    }
+
+    return formula.clauses;
+}
+
+void parse_constraint_line(const std::string& line, Formula& formula) {
+    // XOR lines are written either as "x1 -2 0" or "x 1 -2 0"
+    bool is_xor = line[0] == 'x';
+    std::istringstream iss(is_xor ? line.substr(1) : line);
+    std::vector<int> clause;
+    int literal;
+
+    while (iss >> literal) {
+        if (literal == 0) {
+            break;
+        }
+
+        if (literal != 0) {
+            clause.push_back(literal);
+        }
+    }
+
+    // Cardinality lines end in "<= k" or ">= k" instead of 0; any other
+    // trailing token (e.g. the "%" ending SATLIB files) is ignored
+    std::string op;
+    if (!is_xor && iss.fail() && !iss.eof()) {
+        iss.clear();
+        iss >> op;
+    }
+
+    if (op == "<=" || op == ">=") {
+        int bound;
+        if (!(iss >> bound)) {
+            throw std::runtime_error("Error: Invalid constraint line: " + line);
+        }
+
+        if (op == "<=") {
+            formula.at_most.push_back({clause, bound});
+        } else {
+            // At least k of the literals means at most n - k of their negations
+            std::vector<int> negated;
+            for (int lit : clause) {
+                negated.push_back(-lit);
+            }
+            formula.at_most.push_back({negated, static_cast<int>(clause.size()) - bound});
+        }
+        return;
+    }
+
+    if (clause.empty()) {
+        return;
+    }
+
+    if (is_xor) {
+        formula.xor_clauses.push_back(clause);
+    } else {
+        formula.clauses.push_back(clause);
+    }
+}
+
+Formula parse_dimacs_file(const std::string& filename) {
+    Formula formula;
     std::ifstream file(filename);
 
     if (!file.is_open()) {
@@ -36,7 +105,7 @@ std::vector<std::vector<int>> parse_cnf_file(const std::string& filename) {
             std::string format;
             iss >> format;
 
-            if (format != "cnf") {
+            if (format != "cnf" && format != "cnf+") {
                 throw std::runtime_error("Error: DIMACS file format is not CNF");
             }
 
@@ -62,29 +131,65 @@ std::vector<std::vector<int>> parse_cnf_file(const std::string& filename) {
             continue;
         }
 
-        std::istringstream iss(line);
-        std::vector<int> clause;
-        int literal;
+        parse_constraint_line(line, formula);
+    }
 
-        while (iss >> literal) {
-            if (literal == 0) {
-                break;
-            }
+    size_t num_parsed = formula.clauses.size() + formula.xor_clauses.size() + formula.at_most.size();
+    if (static_cast<int>(num_parsed) != num_clauses) {
+        throw std::runtime_error("Error: Expected " + std::to_string(num_clauses) +
+                                 " clauses but got " + std::to_string(num_parsed));
+    }
 
-            if (literal != 0) {
-                clause.push_back(literal);
-            }
+    return formula;
+}
+
+std::vector<int> parse_model_file(const std::string& filename) {
+    std::ifstream file(filename);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Model file not found: " + filename);
+    }
+
+    std::vector<int> model;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == 'c' || line[0] == 's') {
+            continue;
         }
 
-        if (!clause.empty()) {
-            clauses.push_back(clause);
+        // Solver JSON output: only the "Solution" string holds the model
+        size_t solution_pos = line.find("\"Solution\"");
+        if (solution_pos != std::string::npos) {
+            size_t begin = line.find('"', line.find(':', solution_pos)) + 1;
+            line = line.substr(begin, line.find('"', begin) - begin);
+        } else if (line.find('{') != std::string::npos) {
+            // Other JSON lines (UNSAT results, summaries) hold numbers that are not literals
+            continue;
         }
-    }
 
-    if (static_cast<int>(clauses.size()) != num_clauses) {
-        throw std::runtime_error("Error: Expected " + std::to_string(num_clauses) +
-                                 " clauses but got " + std::to_string(clauses.size()));
+        std::istringstream iss(line);
+        std::string token;
+
+        while (iss >> token) {
+            if (token == "true" || token == "false") {
+                if (model.empty()) {
+                    throw std::runtime_error("Error: Truth value without a variable in model file");
+                }
+                model.back() = (token == "true") ? std::abs(model.back()) : -std::abs(model.back());
+                continue;
+            }
+
+            try {
+                int literal = std::stoi(token);
+                if (literal != 0) {
+                    model.push_back(literal);
+                }
+            } catch (const std::invalid_argument&) {
+                // "v" prefixes and other annotations
+            }
+        }
     }
 
-    return clauses;
-}
\ No newline at end of file
+    return model;
+}
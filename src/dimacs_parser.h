@@ -2,4 +2,17 @@
 #include <vector>
 #include <string>
 
-std::vector<std::vector<int>> parse_cnf_file(const std::string& filename); 
\ No newline at end of file
+#include "formula.h"
+
+std::vector<std::vector<int>> parse_cnf_file(const std::string& filename);
+
+// Like parse_cnf_file, but also accepts the "x" (XOR) and "<= k" / ">= k"
+// (cardinality) line extensions
+Formula parse_dimacs_file(const std::string& filename);
+
+// Appends the clause, XOR or cardinality constraint on one non-comment line
+void parse_constraint_line(const std::string& line, Formula& formula);
+
+// Reads a model as DIMACS "v" lines / plain literals, or in the
+// "1 true 2 false" form of this solver's "Solution" output (JSON lines accepted)
+std::vector<int> parse_model_file(const std::string& filename);
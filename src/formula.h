@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// At most `bound` of the literals may be true
+struct CardinalityConstraint
+{
+    std::vector<int32_t> literals;
+    int32_t bound;
+};
+
+// Everything read from an (extended) DIMACS file.
+struct Formula
+{
+    std::vector<std::vector<int32_t>> clauses;
+
+    // "x" lines: the XOR of the listed literals must be true
+    std::vector<std::vector<int32_t>> xor_clauses;
+
+    // "<=" / ">=" lines (CNF+ format), all normalised to at-most constraints
+    std::vector<CardinalityConstraint> at_most;
+};
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "generators.h"
+using Literal = int32_t;
+using Variable = uint32_t;
+
+namespace {
+
+// Uniform enough for benchmarks, and unlike std::uniform_int_distribution the same everywhere
+uint32_t pick(std::mt19937& rng, uint32_t n) {
+    return rng() % n;
+}
+
+Literal randomSign(std::mt19937& rng, Variable var) {
+    return (rng() & 1) ? static_cast<Literal>(var) : -static_cast<Literal>(var);
+}
+
+std::vector<Variable> distinctVariables(std::mt19937& rng, uint32_t count, uint32_t num_vars) {
+    std::vector<Variable> vars;
+    while (vars.size() < count) {
+        Variable var = pick(rng, num_vars) + 1;
+        if (std::find(vars.begin(), vars.end(), var) == vars.end()) {
+            vars.push_back(var);
+        }
+    }
+    return vars;
+}
+
+} // namespace
+
+Formula random_ksat(uint32_t num_vars, double ratio, uint32_t k, uint32_t seed) {
+    if (k == 0 || k > num_vars) {
+        throw std::invalid_argument("ksat needs 1 <= k <= number of variables");
+    }
+
+    std::mt19937 rng(seed);
+    Formula formula;
+    uint32_t num_clauses = std::lround(ratio * num_vars);
+
+    for (uint32_t i = 0; i < num_clauses; ++i) {
+        std::vector<Literal> clause;
+        for (Variable var : distinctVariables(rng, k, num_vars)) {
+            clause.push_back(randomSign(rng, var));
+        }
+        formula.clauses.push_back(clause);
+    }
+    return formula;
+}
+
+Formula pigeonhole(uint32_t num_holes) {
+    if (num_holes == 0) {
+        throw std::invalid_argument("pigeonhole needs at least one hole");
+    }
+
+    // Variable for "pigeon p sits in hole h"
+    auto sits = [num_holes](uint32_t pigeon, uint32_t hole) {
+        return static_cast<Literal>(pigeon * num_holes + hole + 1);
+    };
+
+    Formula formula;
+    uint32_t num_pigeons = num_holes + 1;
+
+    for (uint32_t p = 0; p < num_pigeons; ++p) {
+        std::vector<Literal> clause;
+        for (uint32_t h = 0; h < num_holes; ++h) {
+            clause.push_back(sits(p, h));
+        }
+        formula.clauses.push_back(clause);
+    }
+
+    for (uint32_t h = 0; h < num_holes; ++h) {
+        for (uint32_t p = 0; p < num_pigeons; ++p) {
+            for (uint32_t q = p + 1; q < num_pigeons; ++q) {
+                formula.clauses.push_back({-sits(p, h), -sits(q, h)});
+            }
+        }
+    }
+    return formula;
+}
+
+Formula random_parity(uint32_t num_vars, uint32_t seed) {
+    if (num_vars < 3) {
+        throw std::invalid_argument("parity needs at least 3 variables");
+    }
+
+    std::mt19937 rng(seed);
+    Formula formula;
+
+    for (uint32_t i = 0; i < num_vars; ++i) {
+        std::vector<Variable> vars = distinctVariables(rng, 3, num_vars);
+        uint32_t parity = rng() & 1;
+
+        // One clause per assignment of the wrong parity, ruling exactly that assignment out
+        for (uint32_t bits = 0; bits < 8; ++bits) {
+            if (static_cast<uint32_t>(__builtin_popcount(bits) & 1) == parity) continue;
+
+            std::vector<Literal> clause;
+            for (uint32_t j = 0; j < 3; ++j) {
+                Literal lit = vars[j];
+                clause.push_back((bits >> j) & 1 ? -lit : lit);
+            }
+            formula.clauses.push_back(clause);
+        }
+    }
+    return formula;
+}
+
+Formula graph_coloring(uint32_t num_vertices, double degree, uint32_t num_colors, uint32_t seed) {
+    if (num_vertices < 2 || num_colors == 0) {
+        throw std::invalid_argument("coloring needs at least 2 vertices and 1 color");
+    }
+
+    std::mt19937 rng(seed);
+    uint64_t max_edges = static_cast<uint64_t>(num_vertices) * (num_vertices - 1) / 2;
+    uint64_t num_edges = std::min<uint64_t>(std::llround(num_vertices * degree / 2), max_edges);
+
+    std::set<std::pair<uint32_t, uint32_t>> edges;
+    while (edges.size() < num_edges) {
+        uint32_t u = pick(rng, num_vertices);
+        uint32_t v = pick(rng, num_vertices);
+        if (u != v) {
+            edges.insert({std::min(u, v), std::max(u, v)});
+        }
+    }
+
+    // Variable for "vertex v has color c"
+    auto colored = [num_colors](uint32_t vertex, uint32_t color) {
+        return static_cast<Literal>(vertex * num_colors + color + 1);
+    };
+
+    Formula formula;
+    for (uint32_t v = 0; v < num_vertices; ++v) {
+        std::vector<Literal> clause;
+        for (uint32_t c = 0; c < num_colors; ++c) {
+            clause.push_back(colored(v, c));
+        }
+        formula.clauses.push_back(clause);
+
+        for (uint32_t c = 0; c < num_colors; ++c) {
+            for (uint32_t d = c + 1; d < num_colors; ++d) {
+                formula.clauses.push_back({-colored(v, c), -colored(v, d)});
+            }
+        }
+    }
+
+    for (const auto& [u, v] : edges) {
+        for (uint32_t c = 0; c < num_colors; ++c) {
+            formula.clauses.push_back({-colored(u, c), -colored(v, c)});
+        }
+    }
+    return formula;
+}
+
+Formula generate_instance(const GeneratorParams& params) {
+    if (params.family == "ksat") {
+        return random_ksat(params.size, params.ratio, params.k, params.seed);
+    }
+    if (params.family == "pigeonhole") {
+        return pigeonhole(params.size);
+    }
+    if (params.family == "parity") {
+        return random_parity(params.size, params.seed);
+    }
+    if (params.family == "coloring") {
+        return graph_coloring(params.size, params.degree, params.colors, params.seed);
+    }
+    throw std::invalid_argument("Unknown instance family: " + params.family);
+}
+
+bool is_seeded_family(const std::string& family) {
+    return family != "pigeonhole";
+}
+
+bool parse_generator_option(int argc, char* argv[], int& i, GeneratorParams& params) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) {
+        return false;
+    }
+
+    if (arg == "--seed") {
+        params.seed = std::stoul(argv[++i]);
+    } else if (arg == "--k") {
+        params.k = std::stoul(argv[++i]);
+    } else if (arg == "--ratio") {
+        params.ratio = std::stod(argv[++i]);
+    } else if (arg == "--colors") {
+        params.colors = std::stoul(argv[++i]);
+    } else if (arg == "--degree") {
+        params.degree = std::stod(argv[++i]);
+    } else {
+        return false;
+    }
+    return true;
+}
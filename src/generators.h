@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+#include "formula.h"
+
+// Benchmark instance families. The same parameters always give the same
+// formula, on every platform (no std:: distributions, whose output is
+// implementation defined).
+struct GeneratorParams
+{
+    std::string family = "ksat"; // "ksat", "pigeonhole", "parity" or "coloring"
+    uint32_t size = 50;          // Variables (ksat, parity), holes (pigeonhole) or vertices (coloring)
+    uint32_t seed = 1;
+
+    uint32_t k = 3;              // ksat: literals per clause
+    double ratio = 4.26;         // ksat: clauses per variable, 4.26 is the 3-SAT phase transition
+    uint32_t colors = 3;         // coloring: number of colors
+    double degree = 4.0;         // coloring: mean vertex degree of the random graph
+};
+
+// Random k-SAT: ratio * size clauses over k distinct variables with random signs
+Formula random_ksat(uint32_t num_vars, double ratio, uint32_t k, uint32_t seed);
+
+// size + 1 pigeons in size holes, always UNSAT
+Formula pigeonhole(uint32_t num_holes);
+
+// size random 3-variable parity constraints over size variables, each written
+// as its 4 CNF clauses; past the 3-XOR-SAT threshold (~0.92 per variable), so
+// mostly UNSAT
+Formula random_parity(uint32_t num_vars, uint32_t seed);
+
+// Colors a random graph with num_vertices * degree / 2 edges
+Formula graph_coloring(uint32_t num_vertices, double degree, uint32_t num_colors, uint32_t seed);
+
+// Dispatches on params.family; throws on an unknown family
+Formula generate_instance(const GeneratorParams& params);
+
+// Whether the family's formula depends on params.seed (pigeonhole does not)
+bool is_seeded_family(const std::string& family);
+
+// Reads a generator option ("--seed", "--k", "--ratio", "--colors" or "--degree")
+// and its value starting at argv[i], advancing i; false if argv[i] is not one
+bool parse_generator_option(int argc, char* argv[], int& i, GeneratorParams& params);
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "instance_features.h"
+
+namespace {
+
+struct ConfigRule
+{
+    const char* name;
+    bool (*applies)(const InstanceFeatures&);
+    void (*apply)(SolverConfig&);
+};
+
+// Evaluated in order, later rules override earlier ones
+const ConfigRule RULES[] = {
+    // Nearly 2-SAT: Jeroslow-Wang weighs short clauses much higher than MOMS. On the
+    // mixed C* instances (50-75% binary) MOMS was faster, hence the high cut-off
+    {"binary-heavy",
+     [](const InstanceFeatures& f) { return f.binary_fraction >= 0.8; },
+     [](SolverConfig& c) { c.branching = SolverConfig::Branching::JEROSLOW_WANG; }},
+    // Both polarities everywhere: pure literals are rare and the per-node scan is wasted
+    {"balanced-polarity",
+     [](const InstanceFeatures& f) { return f.polarity_balance >= 0.8 && f.var_degree_mean >= 8.0; },
+     [](SolverConfig& c) { c.pure_literals = false; }},
+    // XOR recovery sorts every short clause; not worth it on huge formulas without XOR hints
+    {"huge-formula",
+     [](const InstanceFeatures& f) { return f.num_clauses >= 2000000 && f.num_xor_clauses == 0; },
+     [](SolverConfig& c) { c.recover_xors = false; }},
+    // Starting threads costs more than solving (or verifying) a formula this small
+    {"tiny-formula",
+     [](const InstanceFeatures& f) { return f.num_clauses < 512; },
+     [](SolverConfig& c) { c.num_threads = 1; }},
+};
+
+const char* branching_name(SolverConfig::Branching branching) {
+    switch (branching) {
+        case SolverConfig::Branching::JEROSLOW_WANG: return "JEROSLOW_WANG";
+        case SolverConfig::Branching::MOMS: break;
+    }
+    return "MOMS";
+}
+
+} // namespace
+
+InstanceFeatures extract_features(const Formula& formula) {
+    InstanceFeatures features;
+    features.num_clauses = formula.clauses.size();
+    features.num_xor_clauses = formula.xor_clauses.size();
+    features.num_cardinality = formula.at_most.size();
+    features.clause_length_histogram.assign(InstanceFeatures::MAX_HISTOGRAM_LENGTH + 1, 0);
+
+    std::vector<uint32_t> pos_count;
+    std::vector<uint32_t> neg_count;
+    auto count_literal = [&](int32_t lit) {
+        size_t var = std::abs(lit);
+        if (var >= pos_count.size()) {
+            pos_count.resize(var + 1, 0);
+            neg_count.resize(var + 1, 0);
+        }
+        (lit > 0 ? pos_count : neg_count)[var]++;
+    };
+
+    for (const auto& clause : formula.clauses) {
+        size_t length = std::min<size_t>(clause.size(), InstanceFeatures::MAX_HISTOGRAM_LENGTH);
+        features.clause_length_histogram[length]++;
+        for (int32_t lit : clause) {
+            count_literal(lit);
+        }
+    }
+    for (const auto& xor_clause : formula.xor_clauses) {
+        for (int32_t lit : xor_clause) {
+            count_literal(lit);
+        }
+    }
+    for (const auto& card : formula.at_most) {
+        for (int32_t lit : card.literals) {
+            count_literal(lit);
+        }
+    }
+
+    double degree_sum = 0.0;
+    double degree_square_sum = 0.0;
+    double balance_sum = 0.0;
+
+    for (size_t var = 1; var < pos_count.size(); ++var) {
+        uint32_t degree = pos_count[var] + neg_count[var];
+        if (degree == 0) continue;
+
+        features.num_vars++;
+        degree_sum += degree;
+        degree_square_sum += static_cast<double>(degree) * degree;
+        features.var_degree_max = std::max(features.var_degree_max, degree);
+        balance_sum += static_cast<double>(std::min(pos_count[var], neg_count[var])) /
+                       std::max(pos_count[var], neg_count[var]);
+    }
+
+    if (features.num_vars > 0) {
+        features.clause_var_ratio = static_cast<double>(features.num_clauses) / features.num_vars;
+        features.var_degree_mean = degree_sum / features.num_vars;
+        features.var_degree_stddev = std::sqrt(std::max(0.0, degree_square_sum / features.num_vars -
+                                                                 features.var_degree_mean * features.var_degree_mean));
+        features.polarity_balance = balance_sum / features.num_vars;
+    }
+    if (features.num_clauses > 0) {
+        features.binary_fraction = static_cast<double>(features.clause_length_histogram[2]) / features.num_clauses;
+    }
+
+    return features;
+}
+
+SolverConfig choose_config(const InstanceFeatures& features, std::vector<std::string>& applied_rules) {
+    SolverConfig config;
+    for (const ConfigRule& rule : RULES) {
+        if (rule.applies(features)) {
+            rule.apply(config);
+            applied_rules.push_back(rule.name);
+        }
+    }
+    return config;
+}
+
+std::string features_to_json(const InstanceFeatures& features) {
+    std::ostringstream json;
+    json << "{\"Vars\": " << features.num_vars
+         << ", \"Clauses\": " << features.num_clauses
+         << ", \"XorClauses\": " << features.num_xor_clauses
+         << ", \"Cardinality\": " << features.num_cardinality
+         << ", \"ClauseVarRatio\": " << features.clause_var_ratio
+         << ", \"ClauseLengths\": [";
+    for (size_t i = 0; i < features.clause_length_histogram.size(); ++i) {
+        json << (i > 0 ? ", " : "") << features.clause_length_histogram[i];
+    }
+    json << "], \"BinaryFraction\": " << features.binary_fraction
+         << ", \"VarDegreeMean\": " << features.var_degree_mean
+         << ", \"VarDegreeStddev\": " << features.var_degree_stddev
+         << ", \"VarDegreeMax\": " << features.var_degree_max
+         << ", \"PolarityBalance\": " << features.polarity_balance << "}";
+    return json.str();
+}
+
+std::string config_to_json(const SolverConfig& config, const std::vector<std::string>& applied_rules) {
+    std::ostringstream json;
+    json << "{\"Branching\": \"" << branching_name(config.branching) << "\""
+         << ", \"PureLiterals\": " << (config.pure_literals ? "true" : "false")
+         << ", \"RecoverXors\": " << (config.recover_xors ? "true" : "false")
+         << ", \"Threads\": " << config.num_threads
+         << ", \"Rules\": [";
+    for (size_t i = 0; i < applied_rules.size(); ++i) {
+        json << (i > 0 ? ", " : "") << "\"" << applied_rules[i] << "\"";
+    }
+    json << "]}";
+    return json.str();
+}
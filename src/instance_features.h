@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "formula.h"
+#include "solvers/dpll.h"
+
+// Cheap structural statistics of a formula, computed in one pass after parsing
+struct InstanceFeatures
+{
+    static constexpr uint32_t MAX_HISTOGRAM_LENGTH = 8; // Last bucket holds every longer clause
+
+    uint32_t num_vars = 0;
+    uint32_t num_clauses = 0;
+    uint32_t num_xor_clauses = 0;
+    uint32_t num_cardinality = 0;
+
+    double clause_var_ratio = 0.0;
+    std::vector<uint32_t> clause_length_histogram; // Index = clause length
+    double binary_fraction = 0.0;
+
+    double var_degree_mean = 0.0;   // Occurrences per variable
+    double var_degree_stddev = 0.0;
+    uint32_t var_degree_max = 0;
+
+    double polarity_balance = 0.0;  // Mean of min(pos, neg) / max(pos, neg) over variables, 1 = perfectly balanced
+};
+
+InstanceFeatures extract_features(const Formula& formula);
+
+// Picks a configuration from the built-in rule table; the names of the rules
+// that fired are appended to applied_rules
+SolverConfig choose_config(const InstanceFeatures& features, std::vector<std::string>& applied_rules);
+
+std::string features_to_json(const InstanceFeatures& features);
+std::string config_to_json(const SolverConfig& config, const std::vector<std::string>& applied_rules);
@@ -1,60 +1,217 @@
 #include <iostream>
 #include <chrono>
+#include <cmath>
 #include <string>
+#include <sstream>
 #include <filesystem>
+#include <memory>
 #include <stdexcept>
 #include <algorithm>  
 #include <unordered_map> 
 
 #include "dimacs_parser.h"
+#include "instance_features.h"
+#include "output.h"
+#include "server.h"
+#include "solvers/clause_eval.h"
+#include "solvers/components.h"
 #include "solvers/dpll.h"
+#include "solvers/drat.h"
 
-std::string format_solution(const std::vector<int>& assignment) {
-    if (assignment.empty()) {
-        return "";
+bool verify_model(const Formula& formula, const std::vector<int>& model) {
+    // Indexed by original variable; variables missing from the model stay undefined,
+    // which only fails the clauses no other literal satisfies
+    int32_t max_var = 0;
+    for (int lit : model) {
+        max_var = std::max(max_var, std::abs(lit));
+    }
+    for (const auto& clause : formula.clauses) {
+        for (int lit : clause) max_var = std::max(max_var, std::abs(lit));
+    }
+    for (const auto& xor_clause : formula.xor_clauses) {
+        for (int lit : xor_clause) max_var = std::max(max_var, std::abs(lit));
+    }
+    for (const auto& card : formula.at_most) {
+        for (int lit : card.literals) max_var = std::max(max_var, std::abs(lit));
     }
     
-    std::unordered_map<int, bool> var_assignments;
-    for (int lit : assignment) {
-        int var = std::abs(lit);
-        var_assignments[var] = lit > 0;
+    std::vector<int32_t> values(max_var + 1, ClauseValue::UNDEF);
+    for (int lit : model) {
+        values[std::abs(lit)] = lit > 0 ? ClauseValue::TRUE : ClauseValue::FALSE;
     }
     
-    std::string solution;
-    std::vector<int> sorted_vars;
+    auto is_true = [&values](int lit) {
+        return values[std::abs(lit)] == (lit > 0 ? ClauseValue::TRUE : ClauseValue::FALSE);
+    };
     
-    for (const auto& [var, _] : var_assignments) {
-        sorted_vars.push_back(var);
+    if (!verifyClauses(FlatClauses(formula.clauses), values.data())) {
+        return false;
+    }
+    
+    for (const auto& xor_clause : formula.xor_clauses) {
+        bool parity = false;
+        for (int lit : xor_clause) {
+            if (values[std::abs(lit)] == ClauseValue::UNDEF) {
+                return false;
+            }
+            parity ^= is_true(lit);
+        }
+        if (!parity) {
+            return false;
+        }
     }
-    std::sort(sorted_vars.begin(), sorted_vars.end());
     
-    bool first = true;
-    for (int var : sorted_vars) {
-        if (!first) {
-            solution += " ";
+    for (const auto& card : formula.at_most) {
+        int32_t num_true = std::count_if(card.literals.begin(), card.literals.end(), is_true);
+        if (num_true > card.bound) {
+            return false;
         }
-        first = false;
-        solution += std::to_string(var) + " " + (var_assignments[var] ? "true" : "false");
     }
     
-    return solution;
+    return true;
 }
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <cnf file>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <cnf file> [--verify <model file>] [--proof <drat file>]" << std::endl;
+        std::cerr << "       " << argv[0] << " <cnf file> (--enumerate | --count) [--project <var,var,...>]" << std::endl;
+        std::cerr << "       " << argv[0] << " --server [--socket <path>] [--workers <n>] [--timeout <ms>]" << std::endl;
+        return 1;
+    }
+    
+    std::string input_file;
+    std::string model_file;
+    std::string proof_file;
+    bool server_mode = false;
+    bool enumerate_mode = false;
+    bool count_mode = false;
+    std::vector<int> projection;
+    ServerOptions server_options;
+    
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--verify" && i + 1 < argc) {
+                model_file = argv[++i];
+            } else if (arg == "--proof" && i + 1 < argc) {
+                proof_file = argv[++i];
+            } else if (arg == "--enumerate") {
+                enumerate_mode = true;
+            } else if (arg == "--count") {
+                count_mode = true;
+            } else if (arg == "--project" && i + 1 < argc) {
+                std::string vars = argv[++i];
+                std::replace(vars.begin(), vars.end(), ',', ' ');
+                std::istringstream iss(vars);
+                int var;
+                while (iss >> var) {
+                    projection.push_back(var);
+                }
+                if (!iss.eof()) {
+                    throw std::runtime_error("Invalid --project list: " + std::string(argv[i]));
+                }
+            } else if (arg == "--server") {
+                server_mode = true;
+            } else if (arg == "--socket" && i + 1 < argc) {
+                server_options.socket_path = argv[++i];
+            } else if (arg == "--workers" && i + 1 < argc) {
+                server_options.num_workers = std::stoul(argv[++i]);
+            } else if (arg == "--timeout" && i + 1 < argc) {
+                server_options.default_timeout_ms = std::stoul(argv[++i]);
+            } else if (input_file.empty() && arg.rfind("--", 0) != 0) {
+                input_file = arg;
+            } else {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                return 1;
+            }
+        }
+        
+        if (server_mode) {
+            return run_server(server_options);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error occurred: " << e.what() << std::endl;
         return 1;
     }
     
-    const std::string input_file = argv[1];
+    if (input_file.empty()) {
+        std::cerr << "Missing <cnf file>" << std::endl;
+        return 1;
+    }
     const std::string filename = std::filesystem::path(input_file).filename().string();
     
     try {
-        std::vector<std::vector<int>> clauses = parse_cnf_file(input_file);
+        Formula formula = parse_dimacs_file(input_file);
+        
+        if (!model_file.empty()) {
+            std::vector<int> model = parse_model_file(model_file);
+            
+            auto start_time = std::chrono::high_resolution_clock::now();
+            bool verified = verify_model(formula, model);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            
+            std::chrono::duration<double> elapsed_seconds = end_time - start_time;
+            elapsed_seconds = std::chrono::duration<double>(std::round(elapsed_seconds.count() * 100.0) / 100.0);
+            
+            std::cout << "{\"Instance\": \"" << filename
+                      << "\", \"Time\": " << elapsed_seconds.count()
+                      << ", \"Result\": \"" << (verified ? "VERIFIED" : "FAILED") << "\"}" << std::endl;
+            return verified ? 0 : 1;
+        }
+        
+        if (enumerate_mode || count_mode) {
+            if (!proof_file.empty()) {
+                throw std::runtime_error("--proof cannot be combined with --enumerate / --count");
+            }
+            
+            auto start_time = std::chrono::high_resolution_clock::now();
+            std::vector<std::string> applied_rules;
+            SolverConfig config = choose_config(extract_features(formula), applied_rules);
+            
+            // Models stream out as they are found, one JSON line each
+            DPLLSolver solver(formula, config);
+            uint64_t num_models = 0;
+            if (count_mode) {
+                num_models = solver.enumerate(projection);
+            } else {
+                num_models = solver.enumerate(projection, [](const std::vector<int>& model) {
+                    std::cout << "{\"Solution\": \"" << format_solution(model) << "\"}" << std::endl;
+                });
+            }
+            auto end_time = std::chrono::high_resolution_clock::now();
+            
+            std::chrono::duration<double> elapsed_seconds = end_time - start_time;
+            elapsed_seconds = std::chrono::duration<double>(std::round(elapsed_seconds.count() * 100.0) / 100.0);
+            
+            std::cout << "{\"Instance\": \"" << filename
+                      << "\", \"Time\": " << elapsed_seconds.count()
+                      << ", \"Result\": \"" << (num_models > 0 ? "SAT" : "UNSAT") << "\""
+                      << ", \"Models\": " << num_models
+                      << ", \"Decisions\": " << solver.getNumDecisions() << "}" << std::endl;
+            return 0;
+        }
         
         auto start_time = std::chrono::high_resolution_clock::now();
-        DPLLSolver solver(clauses);
+        InstanceFeatures features = extract_features(formula);
+        std::vector<std::string> applied_rules;
+        SolverConfig config = choose_config(features, applied_rules);
+        
+        // Proof steps must be RUP or RAT, which reasoning on recovered XORs is not
+        std::unique_ptr<DratWriter> proof;
+        if (!proof_file.empty()) {
+            config.recover_xors = false;
+            applied_rules.push_back("drat-proof");
+            proof = std::make_unique<DratWriter>(proof_file);
+        }
+        
+        ComponentSolver solver(std::move(formula), config);
+        if (proof) {
+            solver.setProof(proof.get());
+        }
         auto [is_sat, assignment] = solver.solve();
+        if (proof) {
+            proof->flush();
+        }
         auto end_time = std::chrono::high_resolution_clock::now();
         
         std::chrono::duration<double> elapsed_seconds = end_time - start_time;
@@ -66,6 +223,9 @@ int main(int argc, char* argv[]) {
         std::cout << "{\"Instance\": \"" << filename 
                   << "\", \"Time\": " << elapsed_seconds.count() 
                   << ", \"Result\": \"" << result << "\""
+                  << ", \"Features\": " << features_to_json(features)
+                  << ", \"Config\": " << config_to_json(config, applied_rules)
+                  << ", \"Components\": " << solver.getNumComponents()
                   << solution_str << "}" << std::endl;
         
     } catch (const std::exception& e) {
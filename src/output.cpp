@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "output.h"
+
+std::string format_solution(const std::vector<int>& assignment) {
+    if (assignment.empty()) {
+        return "";
+    }
+    
+    std::unordered_map<int, bool> var_assignments;
+    for (int lit : assignment) {
+        int var = std::abs(lit);
+        var_assignments[var] = lit > 0;
+    }
+    
+    std::string solution;
+    std::vector<int> sorted_vars;
+    
+    for (const auto& [var, _] : var_assignments) {
+        sorted_vars.push_back(var);
+    }
+    std::sort(sorted_vars.begin(), sorted_vars.end());
+    
+    bool first = true;
+    for (int var : sorted_vars) {
+        if (!first) {
+            solution += " ";
+        }
+        first = false;
+        solution += std::to_string(var) + " " + (var_assignments[var] ? "true" : "false");
+    }
+    
+    return solution;
+}
+
+void write_dimacs(const Formula& formula, std::ostream& out) {
+    int max_var = 0;
+    auto track = [&max_var](const std::vector<int>& lits) {
+        for (int lit : lits) {
+            max_var = std::max(max_var, std::abs(lit));
+        }
+    };
+    for (const auto& clause : formula.clauses) track(clause);
+    for (const auto& xor_clause : formula.xor_clauses) track(xor_clause);
+    for (const auto& card : formula.at_most) track(card.literals);
+    
+    bool extended = !formula.xor_clauses.empty() || !formula.at_most.empty();
+    size_t num_constraints = formula.clauses.size() + formula.xor_clauses.size() + formula.at_most.size();
+    out << "p " << (extended ? "cnf+" : "cnf") << " " << max_var << " " << num_constraints << "\n";
+    
+    auto write_literals = [&out](const std::vector<int>& lits) {
+        for (int lit : lits) {
+            out << lit << " ";
+        }
+    };
+    for (const auto& clause : formula.clauses) {
+        write_literals(clause);
+        out << "0\n";
+    }
+    for (const auto& xor_clause : formula.xor_clauses) {
+        out << "x ";
+        write_literals(xor_clause);
+        out << "0\n";
+    }
+    for (const auto& card : formula.at_most) {
+        write_literals(card.literals);
+        out << "<= " << card.bound << "\n";
+    }
+}
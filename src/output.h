@@ -0,0 +1,12 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "formula.h"
+
+// "1 true 2 false ..." in variable order, as printed in the "Solution" field
+std::string format_solution(const std::vector<int>& assignment);
+
+// Writes a formula as DIMACS, with "x" and "<=" lines for XOR and cardinality constraints
+void write_dimacs(const Formula& formula, std::ostream& out);
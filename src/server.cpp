@@ -0,0 +1,397 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "server.h"
+#include "dimacs_parser.h"
+#include "instance_features.h"
+#include "output.h"
+#include "solvers/dpll.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class WorkerPool
+{
+public:
+    explicit WorkerPool(uint32_t num_workers) {
+        for (uint32_t i = 0; i < num_workers; ++i) {
+            workers.emplace_back([this]() { run(); });
+        }
+    }
+
+    // Finishes every queued job before returning
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        available.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push(std::move(job));
+        }
+        available.notify_one();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping = false;
+
+    void run() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                available.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop();
+            }
+            job();
+        }
+    }
+};
+
+// Raises a request's interrupt flag once its deadline passes
+class TimeoutWatch
+{
+public:
+    TimeoutWatch() : watcher([this]() { run(); }) {}
+
+    ~TimeoutWatch() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        watcher.join();
+    }
+
+    void add(Clock::time_point deadline, std::weak_ptr<std::atomic<bool>> flag) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            deadlines.emplace(deadline, std::move(flag));
+        }
+        changed.notify_all();
+    }
+
+private:
+    std::multimap<Clock::time_point, std::weak_ptr<std::atomic<bool>>> deadlines;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool stopping = false;
+    std::thread watcher;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            if (deadlines.empty()) {
+                changed.wait(lock);
+                continue;
+            }
+
+            auto first = deadlines.begin();
+            if (Clock::now() < first->first) {
+                changed.wait_until(lock, first->first);
+                continue;
+            }
+
+            if (auto flag = first->second.lock()) {
+                *flag = true;
+            }
+            deadlines.erase(first);
+        }
+    }
+};
+
+// One client stream; jobs keep it alive until their answers are written
+class Connection
+{
+public:
+    Connection(int in_fd, int out_fd, bool owns_fds) : in_fd(in_fd), out_fd(out_fd), owns_fds(owns_fds) {}
+
+    ~Connection() {
+        if (owns_fds) {
+            close(in_fd);
+            if (out_fd != in_fd) close(out_fd);
+        }
+    }
+
+    // Makes a blocked readLine() return, so the session ends
+    void stopReading() {
+        shutdown(in_fd, SHUT_RD);
+    }
+
+    bool readLine(std::string& line) {
+        while (true) {
+            size_t newline = buffer.find('\n');
+            if (newline != std::string::npos) {
+                line = buffer.substr(0, newline);
+                buffer.erase(0, newline + 1);
+                return true;
+            }
+
+            char chunk[65536];
+            ssize_t count = read(in_fd, chunk, sizeof(chunk));
+            if (count < 0 && errno == EINTR) continue;
+            if (count <= 0) {
+                // A last line without a newline still counts
+                line = std::move(buffer);
+                buffer.clear();
+                return !line.empty();
+            }
+            buffer.append(chunk, count);
+        }
+    }
+
+    void send(const std::string& message) {
+        std::string framed = message + "\n";
+        std::lock_guard<std::mutex> lock(write_mutex);
+
+        size_t written = 0;
+        while (written < framed.size()) {
+            ssize_t count = write(out_fd, framed.data() + written, framed.size() - written);
+            if (count < 0 && errno == EINTR) continue;
+            if (count <= 0) return; // Client went away
+            written += count;
+        }
+    }
+
+private:
+    int in_fd;
+    int out_fd;
+    bool owns_fds;
+    std::string buffer;
+    std::mutex write_mutex;
+};
+
+std::string json_escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += (c == '\n' || c == '\r') ? ' ' : c;
+    }
+    return escaped;
+}
+
+// The deadline is taken when the request arrives, so time spent queued counts against it
+void solve_request(uint64_t id, Formula problem, Clock::time_point deadline, Connection& connection,
+                   TimeoutWatch& timeouts) {
+    auto start_time = Clock::now();
+    auto interrupt = std::make_shared<std::atomic<bool>>(start_time >= deadline);
+    if (deadline != Clock::time_point::max()) {
+        timeouts.add(deadline, interrupt);
+    }
+
+    std::ostringstream response;
+    response << "{\"Id\": " << id;
+
+    try {
+        std::vector<std::string> applied_rules;
+        SolverConfig config = choose_config(extract_features(problem), applied_rules);
+        config.num_threads = 1; // The pool already runs one request per thread
+
+        DPLLSolver solver(problem, config);
+        solver.setInterrupt(interrupt.get());
+        auto [is_sat, assignment] = solver.solve();
+
+        std::chrono::duration<double> elapsed_seconds = Clock::now() - start_time;
+        elapsed_seconds = std::chrono::duration<double>(std::round(elapsed_seconds.count() * 100.0) / 100.0);
+        std::string result = is_sat ? "SAT" : (solver.wasInterrupted() ? "UNKNOWN" : "UNSAT");
+
+        response << ", \"Time\": " << elapsed_seconds.count()
+                 << ", \"Result\": \"" << result << "\"";
+        if (is_sat) {
+            response << ", \"Solution\": \"" << format_solution(assignment) << "\"";
+        }
+    } catch (const std::exception& e) {
+        response << ", \"Error\": \"" << json_escape(e.what()) << "\"";
+    }
+
+    response << "}";
+    connection.send(response.str());
+}
+
+void serve_session(std::shared_ptr<Connection> connection, WorkerPool& pool, TimeoutWatch& timeouts,
+                   const ServerOptions& options) {
+    // Cleared rather than rebuilt between problems, so the buffers are reused
+    Formula formula;
+    std::vector<int32_t> assumptions;
+    uint64_t next_id = 1;
+    std::string line;
+
+    while (connection->readLine(line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == 'c') {
+            continue;
+        }
+
+        std::istringstream iss(line);
+        std::string command;
+        iss >> command;
+
+        if (command == "p" || command == "reset") {
+            formula.clauses.clear();
+            formula.xor_clauses.clear();
+            formula.at_most.clear();
+            assumptions.clear();
+        } else if (command == "a") {
+            int32_t literal;
+            while (iss >> literal && literal != 0) {
+                assumptions.push_back(literal);
+            }
+        } else if (command == "solve") {
+            uint32_t timeout_ms = options.default_timeout_ms;
+            iss >> timeout_ms;
+            Clock::time_point deadline = timeout_ms > 0 ? Clock::now() + std::chrono::milliseconds(timeout_ms)
+                                                        : Clock::time_point::max();
+
+            // Assumptions only hold for this solve, as unit clauses on a copy of the problem
+            Formula problem = formula;
+            for (int32_t literal : assumptions) {
+                problem.clauses.push_back({literal});
+            }
+            assumptions.clear();
+
+            uint64_t id = next_id++;
+            pool.submit([id, problem = std::move(problem), deadline, connection, &timeouts]() mutable {
+                solve_request(id, std::move(problem), deadline, *connection, timeouts);
+            });
+        } else if (command == "quit") {
+            break;
+        } else {
+            try {
+                parse_constraint_line(line, formula);
+            } catch (const std::exception& e) {
+                connection->send("{\"Error\": \"" + json_escape(e.what()) + "\"}");
+            }
+        }
+    }
+}
+
+int run_socket_server(const ServerOptions& options, WorkerPool& pool, TimeoutWatch& timeouts) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (options.socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Error: Socket path too long: " + options.socket_path);
+    }
+    std::strcpy(address.sun_path, options.socket_path.c_str());
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throw std::runtime_error(std::string("Error: socket: ") + std::strerror(errno));
+    }
+
+    // Only a stale socket is replaced; any other file at the path is left alone
+    struct stat existing;
+    if (lstat(options.socket_path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            close(listen_fd);
+            throw std::runtime_error("Error: Not a socket, refusing to replace: " + options.socket_path);
+        }
+        unlink(options.socket_path.c_str());
+    }
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, SOMAXCONN) < 0) {
+        std::string error = std::strerror(errno);
+        close(listen_fd);
+        throw std::runtime_error("Error: Cannot listen on " + options.socket_path + ": " + error);
+    }
+
+    // Sessions reference the pool and the watcher, so they are joined before those go away
+    struct Session
+    {
+        std::thread thread;
+        std::weak_ptr<Connection> connection;
+        std::shared_ptr<std::atomic<bool>> finished;
+    };
+    std::vector<Session> sessions;
+
+    auto join_finished = [&sessions](bool stop_all) {
+        for (auto it = sessions.begin(); it != sessions.end();) {
+            if (stop_all) {
+                if (auto connection = it->connection.lock()) connection->stopReading();
+            } else if (!*it->finished) {
+                ++it;
+                continue;
+            }
+            it->thread.join();
+            it = sessions.erase(it);
+        }
+    };
+
+    while (true) {
+        int client_fd = accept(listen_fd, nullptr, nullptr);
+        if (client_fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+        join_finished(false);
+
+        // Sessions only parse; solving happens on the shared pool
+        auto connection = std::make_shared<Connection>(client_fd, client_fd, true);
+        auto finished = std::make_shared<std::atomic<bool>>(false);
+        std::thread thread([connection, finished, &pool, &timeouts, &options]() {
+            serve_session(connection, pool, timeouts, options);
+            *finished = true;
+        });
+        sessions.push_back({std::move(thread), connection, finished});
+    }
+
+    std::string error = std::strerror(errno);
+    close(listen_fd);
+    join_finished(true);
+    throw std::runtime_error("Error: accept: " + error);
+}
+
+} // namespace
+
+int run_server(const ServerOptions& options) {
+    // A client hanging up must not kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    uint32_t num_workers = options.num_workers != 0 ? options.num_workers
+                                                    : std::max(1u, std::thread::hardware_concurrency());
+    TimeoutWatch timeouts;
+    WorkerPool pool(num_workers);
+
+    if (!options.socket_path.empty()) {
+        return run_socket_server(options, pool, timeouts);
+    }
+
+    serve_session(std::make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO, false), pool, timeouts, options);
+    return 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+struct ServerOptions
+{
+    std::string socket_path;          // Empty = one session over stdin/stdout
+    uint32_t num_workers = 0;         // Solver threads, 0 = all hardware threads
+    uint32_t default_timeout_ms = 0;  // Used when "solve" has no timeout, 0 = none
+};
+
+// Long-running mode. Each session is a newline-framed stream of DIMACS lines
+// (clauses, "x" and cardinality lines; a "p" line starts a new problem) and
+// commands:
+//   a <lits> 0          assumptions for the next solve
+//   solve [timeout_ms]  queue the current problem, answered with one JSON line
+//   reset               drop the current problem
+//   quit                end the session
+// Solves run on a shared worker pool and answers carry the request "Id", so
+// they may arrive out of order. Returns the process exit code.
+int run_server(const ServerOptions& options);
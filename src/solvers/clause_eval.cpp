@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "clause_eval.h"
+using Literal = int32_t;
+
+namespace {
+
+const uint32_t CHUNK_LITERALS = 4096;
+const uint32_t MIN_CLAUSES_PER_THREAD = 1 << 16;
+
+// Sets bit i of sat_bits / false_bits when lits[i] is true / false under values
+void literalBits(const Literal *lits, uint32_t count, const int32_t *values,
+                 uint64_t *sat_bits, uint64_t *false_bits) {
+    uint32_t num_words = (count + 63) / 64;
+    std::fill(sat_bits, sat_bits + num_words, 0);
+    std::fill(false_bits, false_bits + num_words, 0);
+
+    uint32_t i = 0;
+#ifdef __AVX2__
+    // 8 literals per step: gather their variables' values and compare against
+    // the value that makes each literal true (1 for positive, 0 for negative)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i lit = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lits + i));
+        __m256i vals = _mm256_i32gather_epi32(values, _mm256_abs_epi32(lit), 4);
+        __m256i want = _mm256_and_si256(_mm256_cmpgt_epi32(lit, zero), one);
+
+        uint64_t sat = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(vals, want)));
+        uint64_t fal = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(vals, _mm256_xor_si256(want, one))));
+
+        sat_bits[i / 64] |= sat << (i % 64);
+        false_bits[i / 64] |= fal << (i % 64);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        int32_t want = lits[i] > 0 ? ClauseValue::TRUE : ClauseValue::FALSE;
+        int32_t value = values[std::abs(lits[i])];
+
+        if (value == want) {
+            sat_bits[i / 64] |= uint64_t(1) << (i % 64);
+        } else if (value != ClauseValue::UNDEF) {
+            false_bits[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+}
+
+uint64_t rangeMask(uint32_t offset, uint32_t length) {
+    uint64_t low = length >= 64 ? ~uint64_t(0) : (uint64_t(1) << length) - 1;
+    return low << offset;
+}
+
+bool anyBit(const uint64_t *bits, uint32_t begin, uint32_t end) {
+    while (begin < end) {
+        uint32_t length = std::min(64 - begin % 64, end - begin);
+        if (bits[begin / 64] & rangeMask(begin % 64, length)) return true;
+        begin += length;
+    }
+    return false;
+}
+
+bool allBits(const uint64_t *bits, uint32_t begin, uint32_t end) {
+    while (begin < end) {
+        uint32_t length = std::min(64 - begin % 64, end - begin);
+        uint64_t mask = rangeMask(begin % 64, length);
+        if ((bits[begin / 64] & mask) != mask) return false;
+        begin += length;
+    }
+    return true;
+}
+
+// Evaluates [begin, end) chunk by chunk; stops at the first falsified clause, or
+// at the first unsatisfied one when only full satisfaction matters
+ClauseEvaluation evaluateRange(const FlatClauses &clauses, const int32_t *values, uint32_t begin, uint32_t end,
+                               bool stop_on_unsatisfied, const std::atomic<bool> *stop) {
+    ClauseEvaluation result{true, false};
+    std::vector<uint64_t> sat_bits;
+    std::vector<uint64_t> false_bits;
+
+    uint32_t first = begin;
+    while (first < end) {
+        if (stop && stop->load(std::memory_order_relaxed)) break;
+
+        uint32_t base = clauses.offsets[first];
+        uint32_t last = first + 1;
+        while (last < end && clauses.offsets[last + 1] - base <= CHUNK_LITERALS) {
+            last++;
+        }
+
+        uint32_t count = clauses.offsets[last] - base;
+        uint32_t num_words = (count + 63) / 64 + 1;
+        if (sat_bits.size() < num_words) {
+            sat_bits.resize(num_words);
+            false_bits.resize(num_words);
+        }
+        literalBits(clauses.literals.data() + base, count, values, sat_bits.data(), false_bits.data());
+
+        for (uint32_t c = first; c < last; ++c) {
+            uint32_t lit_begin = clauses.offsets[c] - base;
+            uint32_t lit_end = clauses.offsets[c + 1] - base;
+
+            if (anyBit(sat_bits.data(), lit_begin, lit_end)) continue;
+
+            result.all_satisfied = false;
+            if (stop_on_unsatisfied) return result;
+
+            if (allBits(false_bits.data(), lit_begin, lit_end)) {
+                result.any_falsified = true;
+                return result;
+            }
+        }
+
+        first = last;
+    }
+
+    return result;
+}
+
+} // namespace
+
+FlatClauses::FlatClauses(const std::vector<std::vector<Literal>> &clauses) : offsets{0} {
+    for (const auto &clause : clauses) {
+        addClause(clause);
+    }
+}
+
+void FlatClauses::addClause(const std::vector<Literal> &clause) {
+    literals.insert(literals.end(), clause.begin(), clause.end());
+    offsets.push_back(literals.size());
+}
+
+ClauseEvaluation evaluateClauses(const FlatClauses &clauses, const int32_t *values, uint32_t begin, uint32_t end) {
+    return evaluateRange(clauses, values, begin, end, false, nullptr);
+}
+
+bool verifyClauses(const FlatClauses &clauses, const int32_t *values, uint32_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, std::max(1u, clauses.size() / MIN_CLAUSES_PER_THREAD));
+
+    if (num_threads == 1) {
+        return evaluateRange(clauses, values, 0, clauses.size(), true, nullptr).all_satisfied;
+    }
+
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> workers;
+    uint32_t per_thread = (clauses.size() + num_threads - 1) / num_threads;
+
+    for (uint32_t t = 0; t < num_threads; ++t) {
+        uint32_t begin = t * per_thread;
+        uint32_t end = std::min(clauses.size(), begin + per_thread);
+
+        workers.emplace_back([&clauses, values, begin, end, &failed]() {
+            if (!evaluateRange(clauses, values, begin, end, true, &failed).all_satisfied) {
+                failed = true;
+            }
+        });
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    return !failed;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// Clauses flattened into one literal array, the layout the evaluation kernels scan
+struct FlatClauses
+{
+    std::vector<int32_t> literals;
+    std::vector<uint32_t> offsets; // Clause i is literals[offsets[i] .. offsets[i + 1])
+
+    FlatClauses() : offsets{0} {}
+    explicit FlatClauses(const std::vector<std::vector<int32_t>> &clauses);
+
+    void addClause(const std::vector<int32_t> &clause);
+    uint32_t size() const { return offsets.size() - 1; }
+};
+
+// Variable values as seen by the kernels, indexed by variable
+namespace ClauseValue
+{
+    constexpr int32_t FALSE = 0;
+    constexpr int32_t TRUE = 1;
+    constexpr int32_t UNDEF = 2;
+}
+
+struct ClauseEvaluation
+{
+    bool all_satisfied;
+    bool any_falsified; // Some clause has every literal false
+};
+
+// Evaluates clauses [begin, end) under a (partial) assignment
+ClauseEvaluation evaluateClauses(const FlatClauses &clauses, const int32_t *values, uint32_t begin, uint32_t end);
+
+// Checks a model against every clause, split into chunks over num_threads
+// threads (0 = all hardware threads); small formulas are checked inline
+bool verifyClauses(const FlatClauses &clauses, const int32_t *values, uint32_t num_threads = 0);
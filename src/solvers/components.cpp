@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "components.h"
+using Literal = int32_t;
+using Variable = uint32_t;
+
+namespace {
+
+Variable maxVariable(const Formula &formula) {
+    Variable max_var = 0;
+    for (const auto &clause : formula.clauses) {
+        for (Literal lit : clause) max_var = std::max<Variable>(max_var, std::abs(lit));
+    }
+    for (const auto &xor_clause : formula.xor_clauses) {
+        for (Literal lit : xor_clause) max_var = std::max<Variable>(max_var, std::abs(lit));
+    }
+    for (const auto &card : formula.at_most) {
+        for (Literal lit : card.literals) max_var = std::max<Variable>(max_var, std::abs(lit));
+    }
+    return max_var;
+}
+
+size_t formulaSize(const Formula &formula) {
+    return formula.clauses.size() + formula.xor_clauses.size() + formula.at_most.size();
+}
+
+class UnionFind
+{
+public:
+    explicit UnionFind(size_t size) : parent(size), rank(size, 0) {
+        for (size_t i = 0; i < size; ++i) parent[i] = i;
+    }
+
+    uint32_t find(uint32_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (rank[a] < rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) rank[a]++;
+    }
+
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint8_t> rank;
+};
+
+} // namespace
+
+ComponentSolver::ComponentSolver(Formula formula, const SolverConfig &config)
+    : config(config), num_components(0), num_decisions(0), num_propagations(0) {
+    std::vector<bool> seen(maxVariable(formula) + 1, false);
+    auto collect = [&](const std::vector<Literal> &lits) {
+        for (Literal lit : lits) {
+            Variable var = std::abs(lit);
+            if (!seen[var]) {
+                seen[var] = true;
+                variables.push_back(var);
+            }
+        }
+    };
+    for (const auto &clause : formula.clauses) collect(clause);
+    for (const auto &xor_clause : formula.xor_clauses) collect(xor_clause);
+    for (const auto &card : formula.at_most) collect(card.literals);
+
+    components = splitComponents(std::move(formula));
+}
+
+std::vector<Formula> ComponentSolver::splitComponents(Formula formula) {
+    Variable max_var = maxVariable(formula);
+    UnionFind sets(max_var + 1);
+
+    auto unite_all = [&sets](const std::vector<Literal> &lits) {
+        for (size_t i = 1; i < lits.size(); ++i) {
+            sets.unite(std::abs(lits[0]), std::abs(lits[i]));
+        }
+    };
+    for (const auto &clause : formula.clauses) unite_all(clause);
+    for (const auto &xor_clause : formula.xor_clauses) unite_all(xor_clause);
+    for (const auto &card : formula.at_most) unite_all(card.literals);
+
+    // Set representative -> component; constraints without variables share one extra component
+    std::vector<int32_t> component_of(max_var + 1, -1);
+    std::vector<Formula> parts;
+    int32_t empty_part = -1;
+
+    auto part_for = [&](const std::vector<Literal> &lits) -> Formula & {
+        if (lits.empty()) {
+            if (empty_part < 0) {
+                empty_part = parts.size();
+                parts.emplace_back();
+            }
+            return parts[empty_part];
+        }
+        uint32_t root = sets.find(std::abs(lits[0]));
+        if (component_of[root] < 0) {
+            component_of[root] = parts.size();
+            parts.emplace_back();
+        }
+        return parts[component_of[root]];
+    };
+
+    // part_for only reads the first literal, so the constraints can be moved out
+    for (auto &clause : formula.clauses) part_for(clause).clauses.push_back(std::move(clause));
+    for (auto &xor_clause : formula.xor_clauses) part_for(xor_clause).xor_clauses.push_back(std::move(xor_clause));
+    for (auto &card : formula.at_most) part_for(card.literals).at_most.push_back(std::move(card));
+
+    return parts;
+}
+
+bool ComponentSolver::simplify(Formula &formula, std::vector<Literal> &fixed, DratWriter *proof) {
+    // Top-level unit propagation over the clauses, with per-literal occurrence lists
+    Variable max_var = maxVariable(formula);
+    std::vector<int8_t> values(max_var + 1, 0);
+    std::vector<std::vector<uint32_t>> occurrences(2 * (max_var + 1));
+    std::vector<uint32_t> num_false(formula.clauses.size(), 0);
+    std::vector<Literal> queue;
+
+    auto code = [](Literal lit) { return 2 * static_cast<size_t>(std::abs(lit)) + (lit < 0); };
+    auto value = [&values](Literal lit) { return lit > 0 ? values[lit] : -values[-lit]; };
+    auto fix = [&](Literal lit) {
+        if (value(lit) != 0) return value(lit) > 0;
+        values[std::abs(lit)] = lit > 0 ? 1 : -1;
+        queue.push_back(lit);
+        if (proof) proof->addClause({lit});
+        return true;
+    };
+
+    for (uint32_t i = 0; i < formula.clauses.size(); ++i) {
+        for (Literal lit : formula.clauses[i]) {
+            occurrences[code(lit)].push_back(i);
+        }
+        if (formula.clauses[i].size() == 1 && !fix(formula.clauses[i][0])) {
+            if (proof) proof->addClause({});
+            return false;
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        for (uint32_t clause_idx : occurrences[code(-queue[head])]) {
+            const auto &clause = formula.clauses[clause_idx];
+            uint32_t false_count = ++num_false[clause_idx];
+
+            if (false_count == clause.size()) {
+                if (proof) proof->addClause({});
+                return false;
+            }
+            if (false_count + 1 != clause.size()) continue;
+
+            for (Literal lit : clause) {
+                if (value(lit) >= 0) {
+                    if (value(lit) == 0) fix(lit);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (queue.empty()) {
+        return true;
+    }
+    fixed.insert(fixed.end(), queue.begin(), queue.end());
+
+    std::vector<std::vector<Literal>> remaining;
+    for (const auto &clause : formula.clauses) {
+        std::vector<Literal> reduced;
+        bool satisfied = false;
+        for (Literal lit : clause) {
+            if (value(lit) > 0) {
+                satisfied = true;
+                break;
+            }
+            if (value(lit) == 0) reduced.push_back(lit);
+        }
+        
+        // The fixed units are already in the proof, which makes the reduced clause RUP
+        if (proof && !satisfied && reduced.size() < clause.size()) proof->addClause(reduced);
+        if (proof && (satisfied || reduced.size() < clause.size())) proof->deleteClause(clause);
+        if (!satisfied) remaining.push_back(reduced);
+    }
+    formula.clauses = std::move(remaining);
+
+    // XOR and cardinality constraints are kept whole, so their fixed variables go back in as units
+    std::vector<bool> kept(max_var + 1, false);
+    auto keep_fixed = [&](const std::vector<Literal> &lits) {
+        for (Literal lit : lits) {
+            Variable var = std::abs(lit);
+            if (values[var] != 0 && !kept[var]) {
+                kept[var] = true;
+                formula.clauses.push_back({values[var] > 0 ? static_cast<Literal>(var) : -static_cast<Literal>(var)});
+            }
+        }
+    };
+    for (const auto &xor_clause : formula.xor_clauses) keep_fixed(xor_clause);
+    for (const auto &card : formula.at_most) keep_fixed(card.literals);
+
+    return true;
+}
+
+std::pair<bool, std::vector<Literal>> ComponentSolver::solve() {
+    std::vector<Literal> fixed;
+    std::vector<Formula> tasks;
+
+    for (Formula &component : components) {
+        size_t num_fixed = fixed.size();
+        if (!simplify(component, fixed, proof)) {
+            return {false, std::vector<Literal>()};
+        }
+        // Without new units the component is unchanged and needs no second split
+        if (fixed.size() == num_fixed) {
+            tasks.push_back(std::move(component));
+            continue;
+        }
+        for (Formula &part : splitComponents(std::move(component))) {
+            tasks.push_back(std::move(part));
+        }
+    }
+    components.clear();
+    num_components = tasks.size();
+
+    // Largest first so a big component does not start last
+    std::sort(tasks.begin(), tasks.end(), [](const Formula &a, const Formula &b) {
+        return formulaSize(a) > formulaSize(b);
+    });
+
+    uint32_t num_threads = config.num_threads != 0 ? config.num_threads : std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::min<uint32_t>(num_threads, tasks.size());
+
+    SolverConfig task_config = config;
+    if (num_threads > 1) {
+        task_config.num_threads = 1;
+    }
+
+    std::atomic<size_t> next_task(0);
+    std::atomic<bool> found_unsat(false);
+    std::vector<std::vector<Literal>> models(tasks.size());
+    std::vector<uint32_t> decisions(tasks.size(), 0);
+    std::vector<uint32_t> propagations(tasks.size(), 0);
+
+    auto worker = [&]() {
+        size_t i;
+        while (!found_unsat && (i = next_task++) < tasks.size()) {
+            DPLLSolver solver(tasks[i], task_config);
+            tasks[i] = Formula(); // The solver keeps its own mapped copy
+            solver.setInterrupt(&found_unsat);
+            if (proof) solver.setProof(proof);
+            auto [is_sat, model] = solver.solve();
+
+            decisions[i] = solver.getNumDecisions();
+            propagations[i] = solver.getNumPropagations();
+            if (is_sat) {
+                models[i] = std::move(model);
+            } else if (!solver.wasInterrupted()) {
+                found_unsat = true;
+            }
+        }
+    };
+
+    if (num_threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> workers;
+        for (uint32_t t = 0; t < num_threads; ++t) {
+            workers.emplace_back(worker);
+        }
+        for (auto &thread : workers) {
+            thread.join();
+        }
+    }
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        num_decisions += decisions[i];
+        num_propagations += propagations[i];
+    }
+
+    if (found_unsat) {
+        return {false, std::vector<Literal>()};
+    }
+
+    // Merge: component models, then top-level units; variables left free default to TRUE
+    std::vector<int8_t> values;
+    auto assign = [&values](Literal lit) {
+        Variable var = std::abs(lit);
+        if (var >= values.size()) values.resize(var + 1, 0);
+        values[var] = lit > 0 ? 1 : -1;
+    };
+    for (const auto &model : models) {
+        for (Literal lit : model) assign(lit);
+    }
+    for (Literal lit : fixed) assign(lit);
+
+    std::vector<Literal> result;
+    for (Literal var : variables) {
+        bool is_false = static_cast<size_t>(var) < values.size() && values[var] < 0;
+        result.push_back(is_false ? -var : var);
+    }
+
+    return {true, result};
+}
+
+void ComponentSolver::setProof(DratWriter *writer) {
+    for (const Formula &component : components) {
+        if (!component.xor_clauses.empty() || !component.at_most.empty()) {
+            throw std::invalid_argument("DRAT proofs cover plain CNF only");
+        }
+    }
+    proof = writer;
+    config.recover_xors = false;
+}
+
+uint32_t ComponentSolver::getNumComponents() const { return num_components; }
+uint32_t ComponentSolver::getNumDecisions() const { return num_decisions; }
+uint32_t ComponentSolver::getNumPropagations() const { return num_propagations; }
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "formula.h"
+#include "dpll.h"
+#include "drat.h"
+
+// Solves the variable-disjoint parts of a formula independently, in parallel.
+// Components are found with union-find at load time and again after top-level
+// unit propagation, which can cut a component apart. Models come back in the
+// original variable numbering.
+class ComponentSolver
+{
+public:
+    ComponentSolver(Formula formula, const SolverConfig &config = SolverConfig());
+
+    // Moves the components into their solvers, so it can only be called once
+    std::pair<bool, std::vector<int32_t>> solve();
+    uint32_t getNumComponents() const;
+    uint32_t getNumDecisions() const;
+    uint32_t getNumPropagations() const;
+
+    // Logs top-level simplification and every component's search as one DRAT
+    // proof; turns off XOR recovery, native constraints are rejected
+    void setProof(DratWriter *writer);
+
+private:
+    SolverConfig config;
+    std::vector<Formula> components;
+    std::vector<int32_t> variables; // Every variable of the input, so the merged model covers them all
+    uint32_t num_components;
+    uint32_t num_decisions;
+    uint32_t num_propagations;
+    DratWriter *proof = nullptr;
+
+    static std::vector<Formula> splitComponents(Formula formula);
+    static bool simplify(Formula &formula, std::vector<int32_t> &fixed, DratWriter *proof);
+};
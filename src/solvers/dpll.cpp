@@ -3,21 +3,37 @@
 #include <unordered_map>
 #include <iostream>
 #include <unordered_set>
+#include <map>
+#include <cmath>
+#include <stdexcept>
 
 #include "dpll.h"
 using Literal = int32_t;
 using Variable = uint32_t;
 using ClauseIndex = uint32_t;
 
-DPLLSolver::DPLLSolver(const std::vector<std::vector<Literal>>& input_clauses) {
+DPLLSolver::DPLLSolver(const std::vector<std::vector<Literal>>& input_clauses)
+    : DPLLSolver(Formula{input_clauses, {}}) {}
+
+DPLLSolver::DPLLSolver(const Formula& formula, const SolverConfig& config) : config(config) {
     std::unordered_set<Variable> unique_vars;
     
-    for (const auto& clause : input_clauses) {
+    for (const auto& clause : formula.clauses) {
         for (Literal lit : clause) {
             Variable var = std::abs(lit);
             unique_vars.insert(var);
         }
     }
+    for (const auto& xor_clause : formula.xor_clauses) {
+        for (Literal lit : xor_clause) {
+            unique_vars.insert(std::abs(lit));
+        }
+    }
+    for (const auto& card : formula.at_most) {
+        for (Literal lit : card.literals) {
+            unique_vars.insert(std::abs(lit));
+        }
+    }
     
     idx_to_var.push_back(0); // Add dummy at index 0
     uint32_t next_idx = 1;
@@ -28,21 +44,52 @@ DPLLSolver::DPLLSolver(const std::vector<std::vector<Literal>>& input_clauses) {
         next_idx++;
     }
     
-    std::vector<std::vector<Literal>> mapped_clauses;
-    for (const auto& clause : input_clauses) {
-        std::vector<Literal> mapped_clause;
-        for (Literal lit : clause) {
+    auto map_literals = [this](const std::vector<Literal>& lits) {
+        std::vector<Literal> mapped;
+        for (Literal lit : lits) {
             Variable var = std::abs(lit);
-            Literal mapped_lit = (lit > 0) ? var_to_idx[var] : -var_to_idx[var];
-            mapped_clause.push_back(mapped_lit);
+            mapped.push_back((lit > 0) ? var_to_idx[var] : -var_to_idx[var]);
         }
-        mapped_clauses.push_back(mapped_clause);
+        return mapped;
+    };
+    
+    std::vector<std::vector<Literal>> mapped_clauses;
+    for (const auto& clause : formula.clauses) {
+        mapped_clauses.push_back(map_literals(clause));
     }
     
     clauses = removeTautologies(mapped_clauses);
+    flat_clauses = FlatClauses(clauses);
     num_vars = idx_to_var.size() - 1;
     
-    assignment.resize(num_vars + 1, Value::UNDEF);
+    for (const auto& xor_clause : formula.xor_clauses) {
+        xor_clauses.push_back(map_literals(xor_clause));
+    }
+    
+    // XORs hidden in the CNF stay as clauses too; Gauss-Jordan only adds reasoning on top
+    if (config.recover_xors) {
+        for (auto& xor_clause : recoverXors(clauses)) {
+            xor_clauses.push_back(std::move(xor_clause));
+        }
+    }
+    gauss = GaussJordan(num_vars, xor_clauses);
+    
+    card_pos_occurrences.resize(num_vars + 1);
+    card_neg_occurrences.resize(num_vars + 1);
+    for (const auto& card : formula.at_most) {
+        uint32_t card_idx = card_literals.size();
+        card_literals.push_back(map_literals(card.literals));
+        card_bounds.push_back(card.bound);
+        
+        for (Literal lit : card_literals.back()) {
+            auto& occurrences = (lit > 0) ? card_pos_occurrences[lit] : card_neg_occurrences[-lit];
+            occurrences.push_back(card_idx);
+        }
+    }
+    card_counters.num_true.assign(card_literals.size(), 0);
+    card_counters.counted.assign(num_vars + 1, false);
+    
+    assignment.resize(num_vars + 1, ClauseValue::UNDEF);
     pos_watches.resize(num_vars + 1);
     neg_watches.resize(num_vars + 1);
     clause_watches.resize(clauses.size());
@@ -62,7 +109,8 @@ std::vector<std::vector<Literal>> DPLLSolver::removeTautologies(const std::vecto
         for (Literal lit : clause) {
             if (clause_set.count(-lit)) {
                 has_contradiction = true;
-                std::cout << "Tautology found and removed: ";
+                std::cerr << "Tautology found and removed: ";
+                removed_tautologies.push_back(clause);
                 break;
             }
         }
@@ -75,6 +123,67 @@ std::vector<std::vector<Literal>> DPLLSolver::removeTautologies(const std::vecto
     return filtered_clauses;
 }
 
+std::vector<std::vector<Literal>> DPLLSolver::recoverXors(const std::vector<std::vector<Literal>>& input_clauses) const {
+    // A k-variable XOR is encoded as the 2^(k-1) clauses over the same variables
+    // whose number of negations has the same parity
+    const size_t MIN_XOR_SIZE = 3;
+    const size_t MAX_XOR_SIZE = 6;
+    
+    // Sorted variable set -> bitset of the sign patterns seen (bit i of a pattern = i-th literal negated)
+    std::map<std::vector<Variable>, uint64_t> patterns;
+    
+    for (const auto& clause : input_clauses) {
+        if (clause.size() < MIN_XOR_SIZE || clause.size() > MAX_XOR_SIZE) continue;
+        
+        std::vector<Literal> sorted_clause = clause;
+        std::sort(sorted_clause.begin(), sorted_clause.end(), [](Literal a, Literal b) {
+            return std::abs(a) < std::abs(b);
+        });
+        
+        std::vector<Variable> vars;
+        uint32_t signs = 0;
+        bool duplicate = false;
+        for (size_t i = 0; i < sorted_clause.size(); ++i) {
+            Variable var = std::abs(sorted_clause[i]);
+            if (!vars.empty() && vars.back() == var) {
+                duplicate = true;
+                break;
+            }
+            vars.push_back(var);
+            if (sorted_clause[i] < 0) signs |= 1u << i;
+        }
+        if (duplicate) continue;
+        
+        patterns[vars] |= uint64_t(1) << signs;
+    }
+    
+    std::vector<std::vector<Literal>> recovered;
+    for (const auto& [vars, seen] : patterns) {
+        uint32_t num_patterns = 1u << vars.size();
+        
+        for (uint32_t parity = 0; parity < 2; ++parity) {
+            bool complete = true;
+            for (uint32_t signs = 0; signs < num_patterns; ++signs) {
+                if ((__builtin_popcount(signs) & 1) == parity && !(seen >> signs & 1)) {
+                    complete = false;
+                    break;
+                }
+            }
+            if (!complete) continue;
+            
+            // Each clause forbids the one assignment with its negated literals true,
+            // so the forbidden parity is the parity of the negations
+            std::vector<Literal> xor_clause(vars.begin(), vars.end());
+            if (parity == 1) {
+                xor_clause[0] = -xor_clause[0];
+            }
+            recovered.push_back(xor_clause);
+        }
+    }
+    
+    return recovered;
+}
+
 void DPLLSolver::initWatches() {
     for (ClauseIndex i = 0; i < clauses.size(); ++i) {
         const auto& clause = clauses[i];
@@ -105,10 +214,14 @@ void DPLLSolver::addWatch(Literal lit, ClauseIndex clause_idx) {
     }
 }
 
+const int32_t* DPLLSolver::values() const {
+    return assignment.data();
+}
+
 DPLLSolver::Value DPLLSolver::getLiteralValue(Literal lit) const {
     DPLLSolver::Value var_value = assignment[std::abs(lit)];
-    if (var_value == DPLLSolver::Value::UNDEF) return DPLLSolver::Value::UNDEF;
-    return (lit > 0) == (var_value == DPLLSolver::Value::TRUE) ? DPLLSolver::Value::TRUE : DPLLSolver::Value::FALSE;
+    if (var_value == ClauseValue::UNDEF) return ClauseValue::UNDEF;
+    return (lit > 0) == (var_value == ClauseValue::TRUE) ? ClauseValue::TRUE : ClauseValue::FALSE;
 }
 
 bool DPLLSolver::findNewWatch(ClauseIndex clause_idx, Literal false_lit) {
@@ -120,7 +233,7 @@ bool DPLLSolver::findNewWatch(ClauseIndex clause_idx, Literal false_lit) {
     Literal other_watch = (watches.first == false_lit) ? watches.second : watches.first;
     
     Value other_watch_value = getLiteralValue(other_watch);
-    if (other_watch_value == Value::TRUE) {
+    if (other_watch_value == ClauseValue::TRUE) {
         return true;
     }
     
@@ -128,7 +241,7 @@ bool DPLLSolver::findNewWatch(ClauseIndex clause_idx, Literal false_lit) {
     for (Literal lit : clause) {
         if (lit != false_lit && lit != other_watch) {
             Value lit_value = getLiteralValue(lit);
-            if (lit_value == Value::TRUE) {
+            if (lit_value == ClauseValue::TRUE) {
                 if (watches.first == false_lit) {
                     watches.first = lit;
                 } else {
@@ -157,7 +270,7 @@ bool DPLLSolver::findNewWatch(ClauseIndex clause_idx, Literal false_lit) {
     for (Literal lit : clause) {
         if (lit != false_lit && lit != other_watch) {
             Value lit_value = getLiteralValue(lit);
-            if (lit_value == Value::UNDEF) {
+            if (lit_value == ClauseValue::UNDEF) {
                 if (watches.first == false_lit) {
                     watches.first = lit;
                 } else {
@@ -189,7 +302,7 @@ bool DPLLSolver::findNewWatch(ClauseIndex clause_idx, Literal false_lit) {
 
 bool DPLLSolver::propagateLiteral(Literal lit) {
     Variable var = std::abs(lit);
-    assignment[var] = (lit > 0) ? Value::TRUE : Value::FALSE;
+    assignment[var] = (lit > 0) ? ClauseValue::TRUE : ClauseValue::FALSE;
     return true;
 }
 
@@ -204,24 +317,31 @@ bool DPLLSolver::unitPropagate() {
             Literal lit = clause[0];
             Variable var = std::abs(lit);
             
-            if (assignment[var] == Value::UNDEF) {
-                assignment[var] = (lit > 0) ? Value::TRUE : Value::FALSE;
+            if (assignment[var] == ClauseValue::UNDEF) {
+                assignment[var] = (lit > 0) ? ClauseValue::TRUE : ClauseValue::FALSE;
                 num_propagations++;
                 
                 if (!in_queue[var]) {
                     propagation_queue.push_back(lit);
                     in_queue[var] = true;
                 }
-            } else if ((lit > 0 && assignment[var] == Value::FALSE) || 
-                       (lit < 0 && assignment[var] == Value::TRUE)) {
+            } else if ((lit > 0 && assignment[var] == ClauseValue::FALSE) || 
+                       (lit < 0 && assignment[var] == ClauseValue::TRUE)) {
                 return false;
             }
         }
     }
     
+    // "<= 0" constraints never see a counter event, so force their literals here
+    for (uint32_t i = 0; i < card_literals.size(); ++i) {
+        if (card_bounds[i] <= 0 && !forceCardinalityFalse(i, propagation_queue, in_queue)) {
+            return false;
+        }
+    }
+    
     for (Variable var = 1; var <= num_vars; var++) {
-        if (assignment[var] != Value::UNDEF && !in_queue[var]) {
-            Literal lit = (assignment[var] == Value::TRUE) ? var : -var;
+        if (assignment[var] != ClauseValue::UNDEF && !in_queue[var]) {
+            Literal lit = (assignment[var] == ClauseValue::TRUE) ? var : -var;
             propagation_queue.push_back(lit);
             in_queue[var] = true;
         }
@@ -231,7 +351,17 @@ bool DPLLSolver::unitPropagate() {
     const size_t MAX_ITERATIONS = 1000000;
     size_t iteration_count = 0;
     
-    while (queue_index < propagation_queue.size() && iteration_count < MAX_ITERATIONS) {
+    while (iteration_count < MAX_ITERATIONS) {
+        if (queue_index == propagation_queue.size()) {
+            // Clause propagation reached a fixpoint, let the XOR matrix contribute
+            if (!propagateXors(propagation_queue, in_queue)) {
+                return false;
+            }
+            if (queue_index == propagation_queue.size()) {
+                break;
+            }
+        }
+        
         iteration_count++;
         
         if (iteration_count >= MAX_ITERATIONS) {
@@ -241,6 +371,10 @@ bool DPLLSolver::unitPropagate() {
         Literal lit = propagation_queue[queue_index++];
         if (lit == 0) continue;
         
+        if (!propagateCardinality(lit, propagation_queue, in_queue)) {
+            return false;
+        }
+        
         Literal false_lit = -lit;
         Variable var = std::abs(lit);
         
@@ -273,23 +407,23 @@ bool DPLLSolver::unitPropagate() {
             
             Value other_value = getLiteralValue(other_watch);
             
-            if (other_value == Value::TRUE) {
+            if (other_value == ClauseValue::TRUE) {
                 i++;
                 continue;
             }
             
-            if (other_value == Value::FALSE) {
+            if (other_value == ClauseValue::FALSE) {
                 return false;
             }
             
             Variable unit_var = std::abs(other_watch);
             if (unit_var > 0 && unit_var <= num_vars) {
-                if (assignment[unit_var] != Value::UNDEF) {
-                    if ((other_watch > 0) != (assignment[unit_var] == Value::TRUE)) {
+                if (assignment[unit_var] != ClauseValue::UNDEF) {
+                    if ((other_watch > 0) != (assignment[unit_var] == ClauseValue::TRUE)) {
                         return false;
                     }
                 } else {
-                    assignment[unit_var] = (other_watch > 0) ? Value::TRUE : Value::FALSE;
+                    assignment[unit_var] = (other_watch > 0) ? ClauseValue::TRUE : ClauseValue::FALSE;
                     num_propagations++;
                     
                     if (!in_queue[unit_var]) {
@@ -306,10 +440,96 @@ bool DPLLSolver::unitPropagate() {
     return true;
 }
 
+bool DPLLSolver::propagateXors(std::vector<Literal>& propagation_queue, std::vector<bool>& in_queue) {
+    if (gauss.empty()) {
+        return true;
+    }
+    
+    for (Variable var : gauss.getVariables()) {
+        if (assignment[var] != ClauseValue::UNDEF && !gauss.isAssigned(var)) {
+            gauss.assign(var, assignment[var] == ClauseValue::TRUE);
+        }
+    }
+    
+    std::vector<Literal> implied;
+    if (!gauss.eliminate(implied)) {
+        return false;
+    }
+    
+    for (Literal lit : implied) {
+        Variable var = std::abs(lit);
+        if (assignment[var] != ClauseValue::UNDEF) {
+            if ((lit > 0) != (assignment[var] == ClauseValue::TRUE)) {
+                return false;
+            }
+            continue;
+        }
+        
+        assignment[var] = (lit > 0) ? ClauseValue::TRUE : ClauseValue::FALSE;
+        num_propagations++;
+        
+        if (!in_queue[var]) {
+            propagation_queue.push_back(lit);
+            in_queue[var] = true;
+        }
+    }
+    
+    return true;
+}
+
+bool DPLLSolver::propagateCardinality(Literal lit, std::vector<Literal>& propagation_queue, std::vector<bool>& in_queue) {
+    Variable var = std::abs(lit);
+    if (card_literals.empty() || card_counters.counted[var]) {
+        return true;
+    }
+    card_counters.counted[var] = true;
+    
+    for (uint32_t card_idx : (lit > 0) ? card_pos_occurrences[var] : card_neg_occurrences[var]) {
+        uint32_t num_true = ++card_counters.num_true[card_idx];
+        int32_t bound = card_bounds[card_idx];
+        
+        if (static_cast<int32_t>(num_true) > bound) {
+            return false;
+        }
+        if (static_cast<int32_t>(num_true) == bound && !forceCardinalityFalse(card_idx, propagation_queue, in_queue)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool DPLLSolver::forceCardinalityFalse(uint32_t cardIdx, std::vector<Literal>& propagation_queue, std::vector<bool>& in_queue) {
+    if (card_bounds[cardIdx] < 0) {
+        return false;
+    }
+    
+    for (Literal lit : card_literals[cardIdx]) {
+        Variable var = std::abs(lit);
+        Value value = getLiteralValue(lit);
+        
+        if (value == ClauseValue::TRUE) continue;
+        if (value == ClauseValue::UNDEF) {
+            assignment[var] = (lit > 0) ? ClauseValue::FALSE : ClauseValue::TRUE;
+            num_propagations++;
+            
+            if (!in_queue[var]) {
+                propagation_queue.push_back(-lit);
+                in_queue[var] = true;
+            }
+        }
+    }
+    
+    return true;
+}
+
 std::pair<bool, std::vector<Literal>> DPLLSolver::solve() {
     // The main entry point for solving the SAT instance
     // This calls the recursive DPLL function and converts the result to original variable indices
     bool is_sat = dpll();
+    if (proof) {
+        proof->flush();
+    }
     
     if (!is_sat) {
         return {false, std::vector<Literal>()};
@@ -317,8 +537,8 @@ std::pair<bool, std::vector<Literal>> DPLLSolver::solve() {
     
     // Assign TRUE to any remaining unassigned variables
     for (Variable var = 1; var <= num_vars; ++var) {
-        if (assignment[var] == Value::UNDEF) {
-            assignment[var] = Value::TRUE;
+        if (assignment[var] == ClauseValue::UNDEF) {
+            assignment[var] = ClauseValue::TRUE;
         }
     }
     
@@ -326,21 +546,22 @@ std::pair<bool, std::vector<Literal>> DPLLSolver::solve() {
     std::vector<Literal> result;
     for (Variable var = 1; var <= num_vars; ++var) {
         Variable original_var = idx_to_var[var];
-        result.push_back(assignment[var] == Value::TRUE ? original_var : -original_var);
+        result.push_back(assignment[var] == ClauseValue::TRUE ? original_var : -original_var);
     }
     
     // Verify that all clauses are satisfied with our assignment
-    for (const auto& clause : clauses) {
-        bool clause_satisfied = false;
-        for (Literal lit : clause) {
-            Variable var = std::abs(lit);
-            if ((lit > 0 && assignment[var] == Value::TRUE) || 
-                (lit < 0 && assignment[var] == Value::FALSE)) {
-                clause_satisfied = true;
-                break;
-            }
+    if (!verifyClauses(flat_clauses, values(), config.num_threads)) {
+        return {false, std::vector<Literal>()};
+    }
+    
+    for (uint32_t i = 0; i < xor_clauses.size(); ++i) {
+        if (!isXorSatisfied(i)) {
+            return {false, std::vector<Literal>()};
         }
-        if (!clause_satisfied) {
+    }
+    
+    for (uint32_t i = 0; i < card_literals.size(); ++i) {
+        if (!isCardinalitySatisfied(i)) {
             return {false, std::vector<Literal>()};
         }
     }
@@ -354,43 +575,50 @@ bool DPLLSolver::dpll(int depth) {
     //     return false;
     // }
     
+    if (interrupt && interrupt->load(std::memory_order_relaxed)) {
+        interrupted = true;
+        return false;
+    }
+    
     // Save current assignment for backtracking
     std::vector<Value> saved_assignment = assignment;
+    GaussJordan::Snapshot saved_gauss = gauss.snapshot();
+    CardinalityCounters saved_card_counters = card_counters;
     
     // STEP 1: Unit Propagation - find and assign variables that must take specific values
     // This is a critical optimization in modern SAT solvers
     if (!unitPropagate()) {
         // If a contradiction is found during propagation, backtrack
+        if (proof) logDecisionClause(false);
         assignment = saved_assignment;
+        gauss.restore(saved_gauss);
+        card_counters = saved_card_counters;
         return false;
     }
     
     // STEP 2: Pure Literal Elimination - assign values to literals that appear with only one polarity
-    pureLiteralEliminate();
+    if (config.pure_literals) {
+        pureLiteralEliminate();
+    }
     
     // STEP 3: Check if all clauses are satisfied with current partial assignment
-    bool allSatisfied = true;
+    ClauseEvaluation evaluation = evaluateClauses(flat_clauses, values(), 0, flat_clauses.size());
     
-    for (uint32_t i = 0; i < clauses.size(); ++i) {
-        if (!isClauseSatisfied(i)) {
-            allSatisfied = false;
-            
-            // Check if the clause can potentially be satisfied with further assignments
-            bool hasPotentialToSatisfy = false;
-            for (Literal lit : clauses[i]) {
-                Variable var = std::abs(lit);
-                if (assignment[var] == Value::UNDEF) {
-                    hasPotentialToSatisfy = true;
-                    break;
-                }
-            }
-            
-            // If a clause cannot be satisfied, backtrack
-            if (!hasPotentialToSatisfy) {
-                assignment = saved_assignment;
-                return false;
-            }
-        }
+    // If a clause cannot be satisfied with further assignments, backtrack
+    if (evaluation.any_falsified) {
+        if (proof) logDecisionClause(false);
+        assignment = saved_assignment;
+        gauss.restore(saved_gauss);
+        card_counters = saved_card_counters;
+        return false;
+    }
+    bool allSatisfied = evaluation.all_satisfied;
+    
+    // The XOR rows must not constrain any unassigned variable either, and no
+    // cardinality constraint may still be violable
+    allSatisfied = allSatisfied && gauss.isSatisfied();
+    for (uint32_t i = 0; allSatisfied && i < card_literals.size(); ++i) {
+        allSatisfied = isCardinalitySatisfied(i);
     }
     
     // If all clauses are satisfied, we've found a solution
@@ -401,6 +629,7 @@ bool DPLLSolver::dpll(int depth) {
     // STEP 4: Choose a variable for branching using a heuristic
     Variable var = pickBranchVariable();
     if (var == 0) {
+        if (proof) logDecisionClause(false);
         return false;
     }
     
@@ -428,7 +657,7 @@ bool DPLLSolver::dpll(int depth) {
                 } else {
                     contains_neg = true;
                 }
-            } else if (assignment[lit_var] == Value::UNDEF) {
+            } else if (assignment[lit_var] == ClauseValue::UNDEF) {
                 has_other_undefined = true;
             }
         }
@@ -452,22 +681,188 @@ bool DPLLSolver::dpll(int depth) {
     }
     
     bool try_true_first = (true_satisfied >= false_satisfied);
+    Literal first_literal = try_true_first ? static_cast<Literal>(var) : -static_cast<Literal>(var);
     
-    assignment[var] = try_true_first ? Value::TRUE : Value::FALSE;
-    if (dpll(depth + 1)) {
+    assignment[var] = try_true_first ? ClauseValue::TRUE : ClauseValue::FALSE;
+    decision_literals.push_back(first_literal);
+    bool found = dpll(depth + 1);
+    decision_literals.pop_back();
+    if (found) {
         return true;
     }
     
     assignment = saved_assignment;
-    assignment[var] = try_true_first ? Value::FALSE : Value::TRUE;
-    if (dpll(depth + 1)) {
+    gauss.restore(saved_gauss);
+    card_counters = saved_card_counters;
+    assignment[var] = try_true_first ? ClauseValue::FALSE : ClauseValue::TRUE;
+    decision_literals.push_back(-first_literal);
+    found = dpll(depth + 1);
+    decision_literals.pop_back();
+    if (found) {
         return true;
     }
     
+    // Both branches failed, so their clauses resolve to this node's; they are not needed any more
+    if (proof && !interrupted) {
+        logDecisionClause(false);
+        logDecisionClause(true, -first_literal);
+        logDecisionClause(true, first_literal);
+    }
+    
     assignment = saved_assignment;
+    gauss.restore(saved_gauss);
+    card_counters = saved_card_counters;
     return false;
 }
 
+uint64_t DPLLSolver::enumerate(const std::vector<Literal>& projection_vars,
+                               const std::function<void(const std::vector<Literal>&)>& on_model) {
+    projection.clear();
+    is_projected.assign(num_vars + 1, false);
+    
+    std::unordered_set<Literal> seen;
+    auto add_projected = [&](Literal var) {
+        if (!seen.insert(var).second) return;
+        auto it = var_to_idx.find(var);
+        Variable idx = it != var_to_idx.end() ? it->second : 0;
+        projection.push_back({var, idx});
+        is_projected[idx] = idx != 0;
+    };
+    
+    if (projection_vars.empty()) {
+        for (Variable var = 1; var <= num_vars; ++var) {
+            add_projected(idx_to_var[var]);
+        }
+    } else {
+        for (Literal lit : projection_vars) {
+            add_projected(std::abs(lit));
+        }
+    }
+    
+    model_callback = on_model ? &on_model : nullptr;
+    num_models = 0;
+    enumerateModels();
+    model_callback = nullptr;
+    
+    return num_models;
+}
+
+void DPLLSolver::enumerateModels() {
+    if (interrupt && interrupt->load(std::memory_order_relaxed)) {
+        interrupted = true;
+        return;
+    }
+    
+    std::vector<Value> saved_assignment = assignment;
+    GaussJordan::Snapshot saved_gauss = gauss.snapshot();
+    CardinalityCounters saved_card_counters = card_counters;
+    auto restore = [&]() {
+        assignment = saved_assignment;
+        gauss.restore(saved_gauss);
+        card_counters = saved_card_counters;
+    };
+    
+    // No pure literal elimination here: it would drop models
+    if (!unitPropagate()) {
+        restore();
+        return;
+    }
+    
+    ClauseEvaluation evaluation = evaluateClauses(flat_clauses, values(), 0, flat_clauses.size());
+    if (evaluation.any_falsified) {
+        restore();
+        return;
+    }
+    
+    bool allSatisfied = evaluation.all_satisfied && gauss.isSatisfied();
+    for (uint32_t i = 0; allSatisfied && i < card_literals.size(); ++i) {
+        allSatisfied = isCardinalitySatisfied(i);
+    }
+    
+    if (allSatisfied) {
+        reportModels();
+        restore();
+        return;
+    }
+    
+    Variable var = pickProjectionVariable();
+    if (var == 0) {
+        // Every projected variable is set: that is one model if the rest can be completed
+        if (dpll()) {
+            reportModels();
+        }
+        restore();
+        return;
+    }
+    
+    num_decisions++;
+    
+    assignment[var] = ClauseValue::TRUE;
+    enumerateModels();
+    
+    restore();
+    assignment[var] = ClauseValue::FALSE;
+    enumerateModels();
+    
+    restore();
+}
+
+void DPLLSolver::reportModels() {
+    // Projected variables the formula no longer constrains take both values
+    std::vector<size_t> free_positions;
+    std::vector<Literal> model;
+    for (size_t i = 0; i < projection.size(); ++i) {
+        auto [var, idx] = projection[i];
+        if (idx == 0 || assignment[idx] == ClauseValue::UNDEF) {
+            free_positions.push_back(i);
+            model.push_back(-var);
+        } else {
+            model.push_back(assignment[idx] == ClauseValue::TRUE ? var : -var);
+        }
+    }
+    
+    if (free_positions.size() >= 64) {
+        throw std::overflow_error("Model count does not fit in 64 bits");
+    }
+    uint64_t num_free_models = uint64_t(1) << free_positions.size();
+    
+    if (!model_callback) {
+        if (num_models + num_free_models < num_models) {
+            throw std::overflow_error("Model count does not fit in 64 bits");
+        }
+        num_models += num_free_models;
+        return;
+    }
+    
+    for (uint64_t mask = 0; mask < num_free_models; ++mask) {
+        if (interrupt && interrupt->load(std::memory_order_relaxed)) {
+            interrupted = true;
+            return;
+        }
+        for (size_t bit = 0; bit < free_positions.size(); ++bit) {
+            Literal var = projection[free_positions[bit]].first;
+            model[free_positions[bit]] = (mask >> bit) & 1 ? var : -var;
+        }
+        (*model_callback)(model);
+        num_models++;
+    }
+}
+
+uint32_t DPLLSolver::pickProjectionVariable() {
+    // The usual heuristic while it picks a projected variable, otherwise the next unassigned one
+    Variable var = pickBranchVariable();
+    if (var != 0 && is_projected[var]) {
+        return var;
+    }
+    
+    for (auto [original, idx] : projection) {
+        if (idx != 0 && assignment[idx] == ClauseValue::UNDEF) {
+            return idx;
+        }
+    }
+    return 0;
+}
+
 void DPLLSolver::pureLiteralEliminate() {
     std::vector<bool> hasPositiveOccurrence(num_vars + 1, false);
     std::vector<bool> hasNegativeOccurrence(num_vars + 1, false);
@@ -480,7 +875,7 @@ void DPLLSolver::pureLiteralEliminate() {
         for (Literal lit : clauses[i]) {
             Variable var = std::abs(lit);
             
-            if (assignment[var] != Value::UNDEF) {
+            if (assignment[var] != ClauseValue::UNDEF) {
                 continue;
             }
             
@@ -492,19 +887,42 @@ void DPLLSolver::pureLiteralEliminate() {
         }
     }
     
+    // XOR variables are never pure: either value can break the parity
+    for (Variable var : gauss.getVariables()) {
+        hasPositiveOccurrence[var] = true;
+        hasNegativeOccurrence[var] = true;
+    }
+    
+    // An at-most constraint only ever wants its literals false
+    for (uint32_t i = 0; i < card_literals.size(); ++i) {
+        if (isCardinalitySatisfied(i)) continue;
+        
+        for (Literal lit : card_literals[i]) {
+            if (lit > 0) {
+                hasNegativeOccurrence[lit] = true;
+            } else {
+                hasPositiveOccurrence[-lit] = true;
+            }
+        }
+    }
+    
+    // In a proof each pure literal p adds (p or the negated decisions): every clause
+    // with -p is satisfied under the propagated decisions, so that clause is RAT on p
     bool assigned_pure_literal = false;
     for (Variable var = 1; var <= num_vars; ++var) {
-        if (assignment[var] != Value::UNDEF) {
+        if (assignment[var] != ClauseValue::UNDEF) {
             continue;
         }
         
         if (hasPositiveOccurrence[var] && !hasNegativeOccurrence[var]) {
-            assignment[var] = Value::TRUE;
+            assignment[var] = ClauseValue::TRUE;
             assigned_pure_literal = true;
+            if (proof) logDecisionClause(false, static_cast<Literal>(var));
         } 
         else if (!hasPositiveOccurrence[var] && hasNegativeOccurrence[var]) {
-            assignment[var] = Value::FALSE;
+            assignment[var] = ClauseValue::FALSE;
             assigned_pure_literal = true;
+            if (proof) logDecisionClause(false, -static_cast<Literal>(var));
         }
     }
     
@@ -525,57 +943,19 @@ bool DPLLSolver::isClauseSatisfied(uint32_t clauseIdx) const {
             continue;
         }
         
-        if ((lit > 0 && assignment[var] == Value::TRUE) || 
-            (lit < 0 && assignment[var] == Value::FALSE)) {
+        if ((lit > 0 && assignment[var] == ClauseValue::TRUE) || 
+            (lit < 0 && assignment[var] == ClauseValue::FALSE)) {
             return true;
         }
     }
     return false;
 }
 
-bool DPLLSolver::allClausesSatisfied() const {
-    bool all_clauses_satisfied = true;
-    bool all_vars_assigned = true;
-    
-    for (uint32_t i = 0; i < clauses.size(); ++i) {
-        bool clause_satisfied = false;
-        
-        for (Literal lit : clauses[i]) {
-            Variable var = std::abs(lit);
-            Value val = assignment[var];
-            
-            if (val == Value::UNDEF) {
-                all_vars_assigned = false;
-            }
-            
-            if ((lit > 0 && val == Value::TRUE) || (lit < 0 && val == Value::FALSE)) {
-                clause_satisfied = true;
-                break;
-            }
-        }
-        
-        if (!clause_satisfied) {
-            all_clauses_satisfied = false;
-            
-            bool has_unassigned = false;
-            for (Literal lit : clauses[i]) {
-                Variable var = std::abs(lit);
-                if (assignment[var] == Value::UNDEF) {
-                    has_unassigned = true;
-                    break;
-                }
-            }
-            
-            if (!has_unassigned) {
-                return false;
-            }
-        }
+Variable DPLLSolver::pickBranchVariable() {
+    if (config.branching == SolverConfig::Branching::JEROSLOW_WANG) {
+        return pickJeroslowWangVariable();
     }
     
-    return all_clauses_satisfied && all_vars_assigned;
-}
-
-Variable DPLLSolver::pickBranchVariable() {
     // Using MOMS heuristic
     uint32_t min_size = UINT32_MAX;
     std::vector<std::vector<uint32_t>> counts(2, std::vector<uint32_t>(num_vars + 1, 0));
@@ -588,7 +968,7 @@ Variable DPLLSolver::pickBranchVariable() {
         uint32_t unassigned_count = 0;
         for (Literal lit : clauses[i]) {
             Variable var = std::abs(lit);
-            if (assignment[var] == Value::UNDEF) {
+            if (assignment[var] == ClauseValue::UNDEF) {
                 unassigned_count++;
                 if (first_unassigned == 0) first_unassigned = var;
             }
@@ -599,14 +979,15 @@ Variable DPLLSolver::pickBranchVariable() {
         }
     }
     
-    if (min_size == UINT32_MAX) return first_unassigned;
+    // Only XOR or cardinality constraints are left to satisfy
+    if (min_size == UINT32_MAX) return first_unassigned != 0 ? first_unassigned : pickConstraintVariable();
     
     for (uint32_t i = 0; i < clauses.size(); ++i) {
         if (isClauseSatisfied(i)) continue;
         
         uint32_t unassigned_count = 0;
         for (Literal lit : clauses[i]) {
-            if (assignment[std::abs(lit)] == Value::UNDEF) {
+            if (assignment[std::abs(lit)] == ClauseValue::UNDEF) {
                 unassigned_count++;
             }
         }
@@ -614,7 +995,7 @@ Variable DPLLSolver::pickBranchVariable() {
         if (unassigned_count == min_size) {
             for (Literal lit : clauses[i]) {
                 Variable var = std::abs(lit);
-                if (assignment[var] == Value::UNDEF) {
+                if (assignment[var] == ClauseValue::UNDEF) {
                     int idx = (lit > 0) ? 1 : 0;
                     counts[idx][var]++;
                 }
@@ -627,7 +1008,7 @@ Variable DPLLSolver::pickBranchVariable() {
     const uint32_t k = 1;
     
     for (Variable var = 1; var <= num_vars; ++var) {
-        if (assignment[var] == Value::UNDEF) {
+        if (assignment[var] == ClauseValue::UNDEF) {
             uint32_t neg = counts[0][var];
             uint32_t pos = counts[1][var];
             uint32_t score = (pos * neg) * (1 << k) + pos + neg;
@@ -642,5 +1023,111 @@ Variable DPLLSolver::pickBranchVariable() {
     return best_var != 0 ? best_var : first_unassigned;
 }
 
+Variable DPLLSolver::pickJeroslowWangVariable() {
+    // Two-sided Jeroslow-Wang: every open clause adds 2^-(unassigned literals) to each of its variables
+    std::vector<double> scores(num_vars + 1, 0.0);
+    
+    for (uint32_t i = 0; i < clauses.size(); ++i) {
+        if (isClauseSatisfied(i)) continue;
+        
+        uint32_t unassigned_count = 0;
+        for (Literal lit : clauses[i]) {
+            if (assignment[std::abs(lit)] == ClauseValue::UNDEF) {
+                unassigned_count++;
+            }
+        }
+        if (unassigned_count == 0) continue;
+        
+        double weight = std::ldexp(1.0, -static_cast<int>(std::min(unassigned_count, 64u)));
+        for (Literal lit : clauses[i]) {
+            Variable var = std::abs(lit);
+            if (assignment[var] == ClauseValue::UNDEF) {
+                scores[var] += weight;
+            }
+        }
+    }
+    
+    Variable best_var = 0;
+    double best_score = 0.0;
+    for (Variable var = 1; var <= num_vars; ++var) {
+        if (assignment[var] == ClauseValue::UNDEF && scores[var] > best_score) {
+            best_score = scores[var];
+            best_var = var;
+        }
+    }
+    
+    // Only XOR or cardinality constraints are left to satisfy
+    return best_var != 0 ? best_var : pickConstraintVariable();
+}
+
+bool DPLLSolver::isXorSatisfied(uint32_t xorIdx) const {
+    bool parity = false;
+    for (Literal lit : xor_clauses[xorIdx]) {
+        if (getLiteralValue(lit) == ClauseValue::TRUE) {
+            parity = !parity;
+        }
+    }
+    return parity;
+}
+
+bool DPLLSolver::isCardinalitySatisfied(uint32_t cardIdx) const {
+    // Satisfied once the literals that are not false cannot exceed the bound
+    int32_t num_not_false = 0;
+    for (Literal lit : card_literals[cardIdx]) {
+        if (getLiteralValue(lit) != ClauseValue::FALSE) {
+            num_not_false++;
+        }
+    }
+    return num_not_false <= card_bounds[cardIdx];
+}
+
+Variable DPLLSolver::pickConstraintVariable() const {
+    Variable var = gauss.pickUnassigned();
+    if (var != 0) return var;
+    
+    for (uint32_t i = 0; i < card_literals.size(); ++i) {
+        if (isCardinalitySatisfied(i)) continue;
+        
+        for (Literal lit : card_literals[i]) {
+            if (getLiteralValue(lit) == ClauseValue::UNDEF) {
+                return std::abs(lit);
+            }
+        }
+    }
+    return 0;
+}
+
 uint32_t DPLLSolver::getNumDecisions() const { return num_decisions; }
-uint32_t DPLLSolver::getNumPropagations() const { return num_propagations; }
\ No newline at end of file
+uint32_t DPLLSolver::getNumPropagations() const { return num_propagations; }
+void DPLLSolver::setInterrupt(const std::atomic<bool>* flag) { interrupt = flag; }
+bool DPLLSolver::wasInterrupted() const { return interrupted; }
+
+void DPLLSolver::setProof(DratWriter *writer) {
+    if (!xor_clauses.empty() || !card_literals.empty()) {
+        throw std::invalid_argument("DRAT proofs cover plain CNF only");
+    }
+    proof = std::make_unique<DratStream>(writer);
+    
+    for (const auto& clause : removed_tautologies) {
+        proof->startClause(true);
+        for (Literal lit : clause) {
+            Literal var = idx_to_var[std::abs(lit)];
+            proof->pushLiteral(lit > 0 ? var : -var);
+        }
+        proof->endClause();
+    }
+}
+
+void DPLLSolver::logDecisionClause(bool is_deletion, Literal first_literal) {
+    // first_literal, then the negated decisions of the current path, in the original numbering
+    proof->startClause(is_deletion);
+    if (first_literal != 0) {
+        Literal var = idx_to_var[std::abs(first_literal)];
+        proof->pushLiteral(first_literal > 0 ? var : -var);
+    }
+    for (Literal lit : decision_literals) {
+        Literal var = idx_to_var[std::abs(lit)];
+        proof->pushLiteral(lit > 0 ? -var : var);
+    }
+    proof->endClause();
+}
\ No newline at end of file
@@ -2,22 +2,61 @@
 #include <vector>
 #include <cstdint>
 #include <unordered_map>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "formula.h"
+#include "clause_eval.h"
+#include "gauss.h"
+#include "drat.h"
+
+// Search strategy knobs, picked per instance by choose_config() in instance_features.h
+struct SolverConfig
+{
+    enum class Branching
+    {
+        MOMS,
+        JEROSLOW_WANG
+    };
+
+    Branching branching = Branching::MOMS;
+    bool pure_literals = true;  // Pure literal elimination at every node
+    bool recover_xors = true;   // Look for XORs encoded in the CNF at load time
+    uint32_t num_threads = 0;   // Threads for component solving and model verification, 0 = all hardware threads
+};
 
 class DPLLSolver
 {
 public:
     DPLLSolver(const std::vector<std::vector<int32_t>> &clauses);
+    DPLLSolver(const Formula &formula, const SolverConfig &config = SolverConfig());
     std::pair<bool, std::vector<int32_t>> solve();
     uint32_t getNumDecisions() const;
     uint32_t getNumPropagations() const;
 
+    // solve() gives up (reporting UNSAT) once the flag is set; wasInterrupted() tells the cases apart
+    void setInterrupt(const std::atomic<bool> *flag);
+    bool wasInterrupted() const;
+
+    // Logs a DRAT refutation to the writer: every failed node adds the negation of
+    // its decisions, and every pure literal p the RAT clause (p or the negated
+    // decisions). Construct the solver with recover_xors off and without native
+    // XOR / cardinality constraints.
+    void setProof(DratWriter *writer);
+
+    // Finds every model projected onto the given original variables (all of them
+    // when empty), each projection once, by branching on projected variables
+    // first; no blocking clauses are added. on_model gets each projected model
+    // as it is found; without it the models are only counted, and projected
+    // variables left free by a satisfied formula count 2^free at once.
+    // Returns the number of models.
+    uint64_t enumerate(const std::vector<int32_t> &projection_vars,
+                       const std::function<void(const std::vector<int32_t> &)> &on_model = nullptr);
+
 private:
-    enum class Value
-    {
-        FALSE,
-        TRUE,
-        UNDEF
-    };
+    // A ClauseValue constant, so the assignment goes to the evaluation kernels as is
+    using Value = int32_t;
 
     struct Watch
     {
@@ -27,11 +66,27 @@ private:
         Watch(int32_t lit, uint32_t idx) : literal(lit), clause_idx(idx) {}
     };
 
+    SolverConfig config;
     std::vector<std::vector<int32_t>> clauses;
+    FlatClauses flat_clauses; // Same clauses, laid out for the evaluation kernels
+    std::vector<std::vector<int32_t>> xor_clauses;
     std::vector<Value> assignment;
     uint32_t num_vars;
     uint32_t num_decisions;
     uint32_t num_propagations;
+    const std::atomic<bool> *interrupt = nullptr;
+    bool interrupted = false;
+
+    // DRAT logging
+    std::unique_ptr<DratStream> proof;
+    std::vector<int32_t> decision_literals;                // Decisions on the current path
+    std::vector<std::vector<int32_t>> removed_tautologies; // Logged as deletions once a proof is set
+
+    // Model enumeration
+    std::vector<std::pair<int32_t, uint32_t>> projection; // Original variable, internal index (0 = not in the formula)
+    std::vector<bool> is_projected;
+    const std::function<void(const std::vector<int32_t> &)> *model_callback = nullptr;
+    uint64_t num_models = 0;
 
     // Variable mapping
     std::unordered_map<int32_t, uint32_t> var_to_idx;
@@ -42,12 +97,31 @@ private:
     std::vector<std::vector<Watch>> neg_watches;             // Watches for negative literals
     std::vector<std::pair<int32_t, int32_t>> clause_watches; // Which literals we're watching in each clause
 
+    // XOR constraints (native and recovered from the CNF), restored with the assignment on backtrack
+    GaussJordan gauss;
+
+    // At-most-k constraints propagated with per-constraint counters of true literals
+    struct CardinalityCounters
+    {
+        std::vector<uint32_t> num_true;
+        std::vector<bool> counted; // Whether a variable's value is already in the counters
+    };
+
+    std::vector<std::vector<int32_t>> card_literals;
+    std::vector<int32_t> card_bounds;
+    std::vector<std::vector<uint32_t>> card_pos_occurrences; // Constraints containing each positive literal
+    std::vector<std::vector<uint32_t>> card_neg_occurrences; // Constraints containing each negative literal
+    CardinalityCounters card_counters;
+
     bool dpll(int depth = 0);
+    void enumerateModels();
+    void reportModels();
+    uint32_t pickProjectionVariable();
     bool unitPropagate();
     void pureLiteralEliminate();
     bool isClauseSatisfied(uint32_t clauseIdx) const;
-    bool allClausesSatisfied() const;
     uint32_t pickBranchVariable();
+    uint32_t pickJeroslowWangVariable();
 
     // New helper methods for watched literals
     void initWatches();
@@ -55,5 +129,18 @@ private:
     void addWatch(int32_t lit, uint32_t clause_idx);
     bool propagateLiteral(int32_t lit);
     Value getLiteralValue(int32_t lit) const;
+    const int32_t *values() const;
+    void logDecisionClause(bool is_deletion, int32_t first_literal = 0);
     std::vector<std::vector<int32_t>> removeTautologies(const std::vector<std::vector<int32_t>> &input_clauses);
+
+    // XOR reasoning
+    std::vector<std::vector<int32_t>> recoverXors(const std::vector<std::vector<int32_t>> &input_clauses) const;
+    bool propagateXors(std::vector<int32_t> &propagation_queue, std::vector<bool> &in_queue);
+    bool isXorSatisfied(uint32_t xorIdx) const;
+
+    // Cardinality reasoning
+    bool propagateCardinality(int32_t lit, std::vector<int32_t> &propagation_queue, std::vector<bool> &in_queue);
+    bool forceCardinalityFalse(uint32_t cardIdx, std::vector<int32_t> &propagation_queue, std::vector<bool> &in_queue);
+    bool isCardinalitySatisfied(uint32_t cardIdx) const;
+    uint32_t pickConstraintVariable() const;
 };
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include <cstdlib>
+#include <stdexcept>
+
+#include "drat.h"
+using Literal = int32_t;
+
+namespace {
+
+const size_t BUFFER_BYTES = 1 << 22;
+
+} // namespace
+
+DratWriter::DratWriter(const std::string &filename) : file(filename, std::ios::binary) {
+    if (!file) {
+        throw std::runtime_error("Error: Cannot open proof file " + filename);
+    }
+    buffer.reserve(2 * BUFFER_BYTES);
+    pending.reserve(2 * BUFFER_BYTES);
+    writer = std::thread([this]() { run(); });
+}
+
+DratWriter::~DratWriter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+}
+
+void DratWriter::addClause(const std::vector<Literal> &clause) {
+    DratStream stream(this);
+    stream.startClause(false);
+    for (Literal lit : clause) stream.pushLiteral(lit);
+    stream.endClause();
+}
+
+void DratWriter::deleteClause(const std::vector<Literal> &clause) {
+    DratStream stream(this);
+    stream.startClause(true);
+    for (Literal lit : clause) stream.pushLiteral(lit);
+    stream.endClause();
+}
+
+void DratWriter::writeBlock(std::vector<uint8_t> &block) {
+    std::unique_lock<std::mutex> lock(mutex);
+    buffer.insert(buffer.end(), block.begin(), block.end());
+    block.clear();
+
+    if (buffer.size() >= BUFFER_BYTES) {
+        handOver(lock);
+    }
+}
+
+void DratWriter::handOver(std::unique_lock<std::mutex> &lock) {
+    // Double buffering: wait for the previous block to be written, then swap
+    changed.wait(lock, [this]() { return pending.empty(); });
+    buffer.swap(pending);
+    changed.notify_all();
+}
+
+void DratWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!buffer.empty()) {
+        handOver(lock);
+    }
+    changed.wait(lock, [this]() { return pending.empty(); });
+}
+
+void DratWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty()) return;
+
+        // The solvers keep filling the other buffer while this one is written
+        lock.unlock();
+        file.write(reinterpret_cast<const char *>(pending.data()), pending.size());
+        file.flush();
+        lock.lock();
+
+        pending.clear();
+        changed.notify_all();
+    }
+}
+
+DratStream::DratStream(DratWriter *writer) : writer(writer) {
+    block.reserve(BLOCK_BYTES + 64);
+}
+
+DratStream::~DratStream() {
+    flush();
+}
+
+void DratStream::flush() {
+    if (!block.empty()) {
+        writer->writeBlock(block);
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// Binary DRAT proof output: 'a' / 'd' records whose literals are encoded as
+// 2 * var + sign in 7-bit groups, each clause ending in a 0 byte. Solver
+// threads encode into their own DratStream and hand over whole blocks; a
+// background thread writes full buffers to disk, so the search only waits
+// when the disk falls behind.
+class DratWriter
+{
+public:
+    explicit DratWriter(const std::string &filename);
+    ~DratWriter();
+
+    DratWriter(const DratWriter &) = delete;
+    DratWriter &operator=(const DratWriter &) = delete;
+
+    // Single records for the few steps logged outside the search; clauses use
+    // the original variable numbering. Safe to call from several threads.
+    void addClause(const std::vector<int32_t> &clause);
+    void deleteClause(const std::vector<int32_t> &clause);
+
+    // Appends encoded records and clears block
+    void writeBlock(std::vector<uint8_t> &block);
+
+    // Blocks until everything recorded so far is on disk
+    void flush();
+
+private:
+    std::ofstream file;
+    std::vector<uint8_t> buffer;  // Being filled by the solvers
+    std::vector<uint8_t> pending; // Handed to the writer thread
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool stopping = false;
+    std::thread writer;
+
+    void handOver(std::unique_lock<std::mutex> &lock);
+    void run();
+};
+
+// One solver thread's view of a proof: records are encoded into a private
+// block without locking, and the block goes to the writer once it is full or
+// on flush(). Records of different streams only interleave block by block.
+class DratStream
+{
+public:
+    explicit DratStream(DratWriter *writer);
+    ~DratStream();
+
+    DratStream(const DratStream &) = delete;
+    DratStream &operator=(const DratStream &) = delete;
+
+    // A record is startClause(), one pushLiteral() per literal, endClause()
+    void startClause(bool is_deletion) { block.push_back(is_deletion ? 'd' : 'a'); }
+    void pushLiteral(int32_t lit) {
+        uint32_t code = 2 * static_cast<uint32_t>(lit < 0 ? -lit : lit) + (lit < 0);
+        while (code >= 0x80) {
+            block.push_back(static_cast<uint8_t>(code | 0x80));
+            code >>= 7;
+        }
+        block.push_back(static_cast<uint8_t>(code));
+    }
+    void endClause() {
+        block.push_back(0);
+        if (block.size() >= BLOCK_BYTES) flush();
+    }
+
+    void flush();
+
+private:
+    static constexpr size_t BLOCK_BYTES = 1 << 16;
+
+    DratWriter *writer;
+    std::vector<uint8_t> block;
+};
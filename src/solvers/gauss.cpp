@@ -0,0 +1,193 @@
+#include <cstdlib>
+#include <vector>
+
+#include "gauss.h"
+using Literal = int32_t;
+using Variable = uint32_t;
+
+GaussJordan::GaussJordan(uint32_t num_vars, const std::vector<std::vector<Literal>> &xor_clauses) {
+    var_to_column.assign(num_vars + 1, -1);
+
+    for (const auto &xor_clause : xor_clauses) {
+        for (Literal lit : xor_clause) {
+            Variable var = std::abs(lit);
+            if (var_to_column[var] < 0) {
+                var_to_column[var] = column_to_var.size();
+                column_to_var.push_back(var);
+            }
+        }
+    }
+
+    num_rows = xor_clauses.size();
+    num_words = (column_to_var.size() + 63) / 64;
+
+    matrix.assign(static_cast<size_t>(num_rows) * num_words, 0);
+    rhs.assign(num_rows, 0);
+    pivots.assign(num_rows, -1);
+    assigned_mask.assign(num_words, 0);
+    pending_mask.assign(num_words, 0);
+    pending_values.assign(num_words, 0);
+
+    for (uint32_t r = 0; r < num_rows; ++r) {
+        // The literals must XOR to true; every negation flips the parity
+        uint8_t parity = 1;
+        for (Literal lit : xor_clauses[r]) {
+            uint32_t col = var_to_column[std::abs(lit)];
+            row(r)[col / 64] ^= uint64_t(1) << (col % 64);
+            if (lit < 0) {
+                parity ^= 1;
+            }
+        }
+        rhs[r] = parity;
+    }
+}
+
+bool GaussJordan::empty() const { return num_rows == 0; }
+
+const std::vector<Variable> &GaussJordan::getVariables() const { return column_to_var; }
+
+bool GaussJordan::isAssigned(Variable var) const {
+    int32_t col = var_to_column[var];
+    if (col < 0) return false;
+    uint64_t bit = uint64_t(1) << (col % 64);
+    return ((assigned_mask[col / 64] | pending_mask[col / 64]) & bit) != 0;
+}
+
+void GaussJordan::assign(Variable var, bool value) {
+    int32_t col = var_to_column[var];
+    if (col < 0) return;
+
+    uint64_t bit = uint64_t(1) << (col % 64);
+    pending_mask[col / 64] |= bit;
+    if (value) {
+        pending_values[col / 64] |= bit;
+    }
+}
+
+bool GaussJordan::hasPending() const {
+    for (uint64_t word : pending_mask) {
+        if (word) return true;
+    }
+    return false;
+}
+
+void GaussJordan::foldPending() {
+    for (uint32_t r = 0; r < num_rows; ++r) {
+        uint64_t *bits = row(r);
+        uint64_t flips = 0;
+
+        for (uint32_t w = 0; w < num_words; ++w) {
+            flips ^= bits[w] & pending_values[w];
+            bits[w] &= ~pending_mask[w];
+        }
+        rhs[r] ^= __builtin_popcountll(flips) & 1;
+
+        int32_t pivot = pivots[r];
+        if (pivot >= 0 && (pending_mask[pivot / 64] >> (pivot % 64) & 1)) {
+            pivots[r] = -1;
+        }
+    }
+
+    for (uint32_t w = 0; w < num_words; ++w) {
+        assigned_mask[w] |= pending_mask[w];
+        pending_mask[w] = 0;
+        pending_values[w] = 0;
+    }
+}
+
+int32_t GaussJordan::firstColumn(uint32_t r) const {
+    const uint64_t *bits = row(r);
+    for (uint32_t w = 0; w < num_words; ++w) {
+        if (bits[w]) {
+            return w * 64 + __builtin_ctzll(bits[w]);
+        }
+    }
+    return -1;
+}
+
+uint32_t GaussJordan::countColumns(uint32_t r, uint32_t limit) const {
+    const uint64_t *bits = row(r);
+    uint32_t count = 0;
+    for (uint32_t w = 0; w < num_words && count < limit; ++w) {
+        count += __builtin_popcountll(bits[w]);
+    }
+    return count;
+}
+
+bool GaussJordan::eliminate(std::vector<Literal> &implied) {
+    if (hasPending()) {
+        foldPending();
+    }
+
+    // Re-pivot rows whose pivot column got assigned (or that never had one)
+    for (uint32_t r = 0; r < num_rows; ++r) {
+        if (pivots[r] >= 0) continue;
+
+        int32_t col = firstColumn(r);
+        if (col < 0) {
+            // 0 = 1 means the XOR system is inconsistent with the assignment
+            if (rhs[r]) return false;
+            continue;
+        }
+
+        pivots[r] = col;
+        const uint64_t *pivot_row = row(r);
+        uint64_t col_bit = uint64_t(1) << (col % 64);
+
+        for (uint32_t s = 0; s < num_rows; ++s) {
+            if (s == r) continue;
+
+            uint64_t *bits = row(s);
+            if (!(bits[col / 64] & col_bit)) continue;
+
+            for (uint32_t w = 0; w < num_words; ++w) {
+                bits[w] ^= pivot_row[w];
+            }
+            rhs[s] ^= rhs[r];
+        }
+    }
+
+    // A row with only its pivot left fixes that variable
+    for (uint32_t r = 0; r < num_rows; ++r) {
+        if (pivots[r] < 0) continue;
+
+        if (countColumns(r, 2) == 1) {
+            Variable var = column_to_var[pivots[r]];
+            implied.push_back(rhs[r] ? static_cast<Literal>(var) : -static_cast<Literal>(var));
+        }
+    }
+
+    return true;
+}
+
+bool GaussJordan::isSatisfied() const {
+    for (uint32_t r = 0; r < num_rows; ++r) {
+        if (pivots[r] >= 0) return false;
+    }
+    return true;
+}
+
+Variable GaussJordan::pickUnassigned() const {
+    for (uint32_t r = 0; r < num_rows; ++r) {
+        if (pivots[r] >= 0) {
+            return column_to_var[pivots[r]];
+        }
+    }
+    return 0;
+}
+
+GaussJordan::Snapshot GaussJordan::snapshot() const {
+    if (empty()) return Snapshot();
+    return Snapshot{matrix, rhs, pivots, assigned_mask, pending_mask, pending_values};
+}
+
+void GaussJordan::restore(const Snapshot &saved) {
+    if (empty()) return;
+    // Same sizes as the live vectors, so these copies reuse their storage
+    matrix = saved.matrix;
+    rhs = saved.rhs;
+    pivots = saved.pivots;
+    assigned_mask = saved.assigned_mask;
+    pending_mask = saved.pending_mask;
+    pending_values = saved.pending_values;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// XOR constraints stored as a bit-packed GF(2) matrix, one row per constraint.
+// The matrix is kept in reduced row echelon form over the unassigned columns:
+// assignments are folded into the right-hand side in word-parallel batches and
+// only rows that lost their pivot are re-eliminated.
+class GaussJordan
+{
+public:
+    // The part that changes during search (matrix, right-hand side, pivots and
+    // masks); the column maps stay put, so backtracking restores only this
+    struct Snapshot
+    {
+        std::vector<uint64_t> matrix;
+        std::vector<uint8_t> rhs;
+        std::vector<int32_t> pivots;
+        std::vector<uint64_t> assigned_mask;
+        std::vector<uint64_t> pending_mask;
+        std::vector<uint64_t> pending_values;
+    };
+
+    GaussJordan() = default;
+    // Each XOR is a list of literals whose exclusive or must be true
+    GaussJordan(uint32_t num_vars, const std::vector<std::vector<int32_t>> &xor_clauses);
+
+    bool empty() const;
+    const std::vector<uint32_t> &getVariables() const;
+    bool isAssigned(uint32_t var) const;
+    void assign(uint32_t var, bool value);
+
+    // Returns false on conflict, otherwise appends the literals forced by rows
+    // that have a single unassigned column left
+    bool eliminate(std::vector<int32_t> &implied);
+
+    // True when no row constrains an unassigned column any more
+    bool isSatisfied() const;
+    uint32_t pickUnassigned() const;
+
+    // Both are no-ops without XORs, so plain CNF search pays nothing
+    Snapshot snapshot() const;
+    void restore(const Snapshot &saved);
+
+private:
+    uint32_t num_rows = 0;
+    uint32_t num_words = 0;
+
+    std::vector<uint64_t> matrix;   // num_rows * num_words bits
+    std::vector<uint8_t> rhs;
+    std::vector<int32_t> pivots;    // Pivot column of each row, -1 if none
+
+    std::vector<uint32_t> column_to_var;
+    std::vector<int32_t> var_to_column;
+
+    std::vector<uint64_t> assigned_mask;
+    std::vector<uint64_t> pending_mask;   // Assigned but not yet folded into the rows
+    std::vector<uint64_t> pending_values;
+
+    uint64_t *row(uint32_t r) { return matrix.data() + static_cast<size_t>(r) * num_words; }
+    const uint64_t *row(uint32_t r) const { return matrix.data() + static_cast<size_t>(r) * num_words; }
+    bool hasPending() const;
+    void foldPending();
+    int32_t firstColumn(uint32_t r) const;
+    uint32_t countColumns(uint32_t r, uint32_t limit) const;
+};
@@ -0,0 +1,216 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <stdexcept>
+
+#include "generators.h"
+#include "instance_features.h"
+#include "solvers/dpll.h"
+
+// Raises a solver's interrupt flag if it runs past its time limit
+class Deadline
+{
+public:
+    Deadline(std::atomic<bool>& flag, double seconds)
+        : watcher([this, &flag, seconds]() {
+              std::unique_lock<std::mutex> lock(mutex);
+              if (!changed.wait_for(lock, std::chrono::duration<double>(seconds), [this]() { return done; })) {
+                  flag = true;
+              }
+          }) {}
+
+    ~Deadline() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        changed.notify_all();
+        watcher.join();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool done = false;
+    std::thread watcher;
+};
+
+struct SizeResult
+{
+    uint32_t size;
+    double median_time;
+    double mean_decisions;
+    double mean_propagations;
+};
+
+// Least squares slope and R^2 of y over x
+std::pair<double, double> fit_line(const std::vector<double>& x, const std::vector<double>& y) {
+    double n = x.size();
+    double mean_x = 0, mean_y = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        mean_x += x[i] / n;
+        mean_y += y[i] / n;
+    }
+
+    double sxy = 0, sxx = 0, syy = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        sxy += (x[i] - mean_x) * (y[i] - mean_y);
+        sxx += (x[i] - mean_x) * (x[i] - mean_x);
+        syy += (y[i] - mean_y) * (y[i] - mean_y);
+    }
+    if (sxx == 0) {
+        return {0.0, 0.0};
+    }
+
+    double slope = sxy / sxx;
+    double r2 = syy == 0 ? 1.0 : (sxy * sxy) / (sxx * syy);
+    return {slope, r2};
+}
+
+// Fits y ~ size^a (log-log) and y ~ b^size (log-linear), so runs of two
+// solver versions can be compared by their exponent and growth rate
+std::string growth_to_json(const std::vector<SizeResult>& results, double SizeResult::*metric) {
+    std::vector<double> sizes, log_sizes, log_values;
+    for (const auto& result : results) {
+        if (result.*metric <= 0) continue;
+        sizes.push_back(result.size);
+        log_sizes.push_back(std::log(result.size));
+        log_values.push_back(std::log(result.*metric));
+    }
+
+    std::ostringstream json;
+    if (sizes.size() < 2) {
+        json << "null";
+        return json.str();
+    }
+
+    auto [poly_exponent, poly_r2] = fit_line(log_sizes, log_values);
+    auto [exp_slope, exp_r2] = fit_line(sizes, log_values);
+    json << "{\"PolyExponent\": " << poly_exponent << ", \"PolyR2\": " << poly_r2
+         << ", \"ExpRate\": " << std::exp(exp_slope) << ", \"ExpR2\": " << exp_r2 << "}";
+    return json.str();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <ksat|pigeonhole|parity|coloring> <from size> <to size>"
+                  << " [--step <n>] [--seeds <n>] [--timeout <seconds>]"
+                  << " [--seed <n>] [--k <n>] [--ratio <r>] [--colors <n>] [--degree <d>]" << std::endl;
+        return 1;
+    }
+
+    try {
+        GeneratorParams params;
+        params.family = argv[1];
+        uint32_t from_size = std::stoul(argv[2]);
+        uint32_t to_size = std::stoul(argv[3]);
+        uint32_t step = 10;
+        uint32_t num_seeds = 5;
+        double timeout = 10.0;
+
+        for (int i = 4; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--step" && i + 1 < argc) {
+                step = std::max(1ul, std::stoul(argv[++i]));
+            } else if (arg == "--seeds" && i + 1 < argc) {
+                num_seeds = std::max(1ul, std::stoul(argv[++i]));
+            } else if (arg == "--timeout" && i + 1 < argc) {
+                timeout = std::stod(argv[++i]);
+            } else if (!parse_generator_option(argc, argv, i, params)) {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                return 1;
+            }
+        }
+
+        // Every seed would give the same formula, so one run per size is enough
+        if (!is_seeded_family(params.family)) {
+            num_seeds = 1;
+        }
+
+        uint32_t first_seed = params.seed;
+        std::vector<SizeResult> results;
+
+        for (uint32_t size = from_size; size <= to_size; size += step) {
+            params.size = size;
+            std::vector<double> times;
+            double total_decisions = 0, total_propagations = 0;
+            uint32_t num_sat = 0, num_timeouts = 0;
+            InstanceFeatures features;
+
+            for (uint32_t s = 0; s < num_seeds; ++s) {
+                params.seed = first_seed + s;
+                Formula formula = generate_instance(params);
+
+                // Same pipeline as dpll_solver, minus component splitting so the run can be timed out
+                auto start_time = std::chrono::high_resolution_clock::now();
+                features = extract_features(formula);
+                std::vector<std::string> applied_rules;
+                SolverConfig config = choose_config(features, applied_rules);
+
+                std::atomic<bool> interrupt(false);
+                DPLLSolver solver(formula, config);
+                solver.setInterrupt(&interrupt);
+                bool is_sat;
+                {
+                    Deadline deadline(interrupt, timeout);
+                    is_sat = solver.solve().first;
+                }
+                auto end_time = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> elapsed_seconds = end_time - start_time;
+
+                times.push_back(elapsed_seconds.count());
+                if (solver.wasInterrupted()) {
+                    num_timeouts++;
+                    continue;
+                }
+                num_sat += is_sat;
+                total_decisions += solver.getNumDecisions();
+                total_propagations += solver.getNumPropagations();
+            }
+
+            // Timed-out runs count as the time limit in the median and are left out of the means
+            std::sort(times.begin(), times.end());
+            double median_time = times[times.size() / 2];
+            uint32_t num_solved = num_seeds - num_timeouts;
+            double mean_decisions = num_solved > 0 ? total_decisions / num_solved : 0;
+            double mean_propagations = num_solved > 0 ? total_propagations / num_solved : 0;
+
+            std::cout << "{\"Family\": \"" << params.family
+                      << "\", \"Size\": " << size
+                      << ", \"Vars\": " << features.num_vars
+                      << ", \"Clauses\": " << features.num_clauses
+                      << ", \"Runs\": " << num_seeds
+                      << ", \"Timeouts\": " << num_timeouts
+                      << ", \"Sat\": " << num_sat
+                      << ", \"MedianTime\": " << median_time
+                      << ", \"MeanDecisions\": " << mean_decisions
+                      << ", \"MeanPropagations\": " << mean_propagations << "}" << std::endl;
+
+            if (num_timeouts > num_seeds / 2) {
+                break; // The median is the time limit from here on
+            }
+            results.push_back({size, median_time, mean_decisions, mean_propagations});
+        }
+
+        std::cout << "{\"Family\": \"" << params.family
+                  << "\", \"Sizes\": " << results.size()
+                  << ", \"Growth\": {\"Time\": " << growth_to_json(results, &SizeResult::median_time)
+                  << ", \"Decisions\": " << growth_to_json(results, &SizeResult::mean_decisions)
+                  << ", \"Propagations\": " << growth_to_json(results, &SizeResult::mean_propagations)
+                  << "}}" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
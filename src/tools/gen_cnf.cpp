@@ -0,0 +1,52 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+
+#include "generators.h"
+#include "output.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <ksat|pigeonhole|parity|coloring> <size> [-o <cnf file>]"
+                  << " [--seed <n>] [--k <n>] [--ratio <r>] [--colors <n>] [--degree <d>]" << std::endl;
+        return 1;
+    }
+
+    try {
+        GeneratorParams params;
+        params.family = argv[1];
+        params.size = std::stoul(argv[2]);
+        std::string output_file;
+
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-o" && i + 1 < argc) {
+                output_file = argv[++i];
+            } else if (!parse_generator_option(argc, argv, i, params)) {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                return 1;
+            }
+        }
+
+        Formula formula = generate_instance(params);
+
+        std::ofstream file;
+        if (!output_file.empty()) {
+            file.open(output_file);
+            if (!file) {
+                throw std::runtime_error("Error: Cannot write " + output_file);
+            }
+        }
+        std::ostream& out = output_file.empty() ? std::cout : file;
+
+        out << "c " << params.family << " size " << params.size << " seed " << params.seed << "\n";
+        write_dimacs(formula, out);
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}